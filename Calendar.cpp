@@ -1,26 +1,327 @@
 #include "Calendar.h"
-#include <sstream>
-#include <iomanip>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 
 Calendar::Calendar(const Date& date) : currentDate(date) {}
 
+MergedEventCursor::MergedEventCursor(const Calendar& calendar, const Date& start, const Date& end)
+    : calendar(&calendar),
+      hot(calendar.getEventCursor(start, end)),
+      archived(calendar.archive.getCursor(start, end)),
+      expandedDay(start.toSerial() - 1),
+      lastDay(end.toSerial()) {
+    // Nothing recurs before the earliest series starts
+    int firstStart = std::numeric_limits<int>::max();
+    for (const auto& series : calendar.recurring) {
+        firstStart = std::min(firstStart, series.master->getDate().toSerial());
+    }
+    expandedDay = std::max(expandedDay, std::min(firstStart - 1, lastDay));
+    expand();
+}
+
+void MergedEventCursor::expand() {
+    while (occurrence == occurrences.size() && expandedDay < lastDay) {
+        int from = expandedDay + 1;
+        int to = lastDay - from < window ? lastDay : from + window - 1;
+        occurrences = calendar->getOccurrences(Date::fromSerial(from), Date::fromSerial(to));
+        occurrence = 0;
+        expandedDay = to;
+        window = occurrences.empty() && window < lastDay - from ? window * 2 : OCCURRENCE_WINDOW;
+    }
+}
+
+MergedEventCursor::Source MergedEventCursor::head() const {
+    // Ties go to archived events, then occurrences, as in the date-bounded queries
+    Source source = Source::HOT;
+    bool found = hot.hasNext();
+    EventKey key = found ? hot.peekKey() : EventKey();
+    if (occurrence < occurrences.size() && (!found || !(key < occurrences[occurrence]->sortKey()))) {
+        source = Source::RECURRING;
+        key = occurrences[occurrence]->sortKey();
+        found = true;
+    }
+    if (archived.hasNext() && (!found || !(key < archived.peekKey()))) {
+        source = Source::ARCHIVED;
+    }
+    return source;
+}
+
+const std::shared_ptr<const Event>& MergedEventCursor::peek() const {
+    switch (head()) {
+    case Source::ARCHIVED: return archived.peek();
+    case Source::RECURRING: return occurrences[occurrence];
+    default: return hot.peek();
+    }
+}
+
+std::shared_ptr<const Event> MergedEventCursor::next() {
+    switch (head()) {
+    case Source::ARCHIVED:
+        return archived.next();
+    case Source::RECURRING: {
+        std::shared_ptr<const Event> event = std::move(occurrences[occurrence++]);
+        expand();
+        return event;
+    }
+    default:
+        return hot.next();
+    }
+}
+
 void Calendar::addEvent(const Event& event) {
-    events.push_back(std::make_shared<Event>(event));
+    addEvent(std::make_shared<Event>(event));
+}
+
+void Calendar::addEvent(Event&& event) {
+    addEvent(std::make_shared<Event>(std::move(event)));
 }
 
 void Calendar::addEvent(std::shared_ptr<Event> event) {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::ADD_EVENT);
+    // Same text, so the event looks unchanged; repeated titles now share one string
+    event->setTitle(strings.intern(event->getTitleHandle()));
+    event->setDescription(strings.intern(event->getDescriptionHandle()));
     events.push_back(event);
+    if (columnar) {
+        columns.push(*event);
+    }
+    indexEvent(event);
+    if (history) {
+        history->addEvent(std::shared_ptr<const Event>(event));
+    }
 }
 
 void Calendar::removeEvent(const Event& event) {
-    auto it = std::remove_if(events.begin(), events.end(),
-        [&event](const std::shared_ptr<Event>& e) {
-            return *e == event;
+    CALENDAR_METRICS_SCOPE(CalendarOperation::REMOVE_EVENT);
+    CALENDAR_METRICS_SCANNED(events.size());
+
+    // Rows are taken before the partition reorders events; only rows on the event's day can match
+    std::vector<std::uint32_t> rows;
+    if (columnar) {
+        ColumnFilter sameDay;
+        sameDay.firstDay = sameDay.lastDay = event.getDate().toSerial();
+        for (std::uint32_t row : columns.select(sameDay)) {
+            if (*events[row] == event) {
+                rows.push_back(row);
+            }
+        }
+    }
+
+    auto it = std::stable_partition(events.begin(), events.end(),
+        [&event](const std::shared_ptr<const Event>& e) {
+            return !(*e == event);
         });
 
+    for (auto removed = it; removed != events.end(); ++removed) {
+        unindexEvent(*removed);
+    }
+    CALENDAR_METRICS_RETURNED(static_cast<size_t>(events.end() - it));
+
     if (it != events.end()) {
         events.erase(it, events.end());
+        columns.erase(rows);
+        if (history) {
+            history->removeEvent(event);
+        }
+    }
+}
+
+size_t Calendar::archiveBefore(const Date& cutoff) {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::ARCHIVE_EVENTS);
+    auto last = index.lower_bound({ cutoff.toSerial(), std::numeric_limits<int>::min() });
+
+    std::vector<std::shared_ptr<const Event>> archived;
+    for (auto it = index.begin(); it != last; ++it) {
+        archived.push_back(it->second);
+    }
+    CALENDAR_METRICS_RETURNED(archived.size());
+    if (archived.empty()) {
+        return 0;
+    }
+
+    archive.add(archived);
+    queryCache.clear();
+
+    // Counters keep covering archived events, so only the other indexes are updated
+    for (const auto& event : archived) {
+        textIndex.remove(event);
+        titleIndex.remove(event->getTitle());
+    }
+    index.erase(index.begin(), last);
+
+    int cutoffDay = cutoff.toSerial();
+    if (columnar) {
+        ColumnFilter before;
+        before.lastDay = cutoffDay - 1;
+        columns.erase(columns.select(before));
+    }
+    events.erase(std::remove_if(events.begin(), events.end(),
+        [cutoffDay](const std::shared_ptr<const Event>& event) {
+            return event->sortKey().first < cutoffDay;
+        }), events.end());
+
+    if (history) {
+        size_t limit = history->getLimit();
+        history.reset();
+        setHistoryLimit(limit);
+    }
+    return archived.size();
+}
+
+std::vector<std::shared_ptr<const Event>> Calendar::collectEvents(const Date& start, const Date& end) const {
+    std::vector<std::shared_ptr<const Event>> result;
+    MergedEventCursor cursor = getMergedCursor(start, end);
+    while (cursor.hasNext()) {
+        result.push_back(cursor.next());
+    }
+    return result;
+}
+
+void Calendar::setQueryCacheBudget(size_t bytes) {
+    queryCache.setBudget(bytes);
+}
+
+void Calendar::setHistoryLimit(size_t versions) {
+    if (versions == 0) {
+        history.reset();
+    }
+    else if (history) {
+        history->setLimit(versions);
+    }
+    else {
+        EventStore current;
+        for (const auto& entry : index) {
+            current = current.insert(entry.second);
+        }
+        history.emplace(versions, std::move(current));
+    }
+}
+
+EventStore Calendar::getSnapshot(size_t version) const {
+    if (!history) {
+        throw std::logic_error("Calendar history is disabled");
+    }
+    return history->asOf(version);
+}
+
+bool Calendar::undo() {
+    if (!canUndo()) {
+        return false;
+    }
+    restoreVersion(history->asOf(history->version() - 1));
+    history->undo();
+    return true;
+}
+
+bool Calendar::redo() {
+    if (!canRedo()) {
+        return false;
+    }
+    restoreVersion(history->asOf(history->version() + 1));
+    history->redo();
+    return true;
+}
+
+void Calendar::restoreVersion(const EventStore& target) {
+    std::vector<std::shared_ptr<const Event>> removed;
+    std::vector<std::shared_ptr<const Event>> added;
+    history->current().compare(target, removed, added);
+
+    for (const auto& event : removed) {
+        auto it = std::find(events.begin(), events.end(), event);
+        if (it != events.end()) {
+            if (columnar) {
+                columns.erase({ static_cast<std::uint32_t>(it - events.begin()) });
+            }
+            events.erase(it);
+            unindexEvent(event);
+        }
+    }
+    // Versions hold the calendar's own event objects, so they go back in as they are
+    for (const auto& event : added) {
+        events.push_back(event);
+        if (columnar) {
+            columns.push(*event);
+        }
+        indexEvent(event);
+    }
+}
+
+void Calendar::setColumnarScans(bool enabled) {
+    columnar = enabled;
+    if (enabled) {
+        columns.assign(events);
+    }
+    else {
+        columns = EventColumns();
+    }
+}
+
+void Calendar::addRecurringEvent(const Event& master, const RecurrenceRule& rule) {
+    addRecurringEvent(std::make_shared<Event>(master), rule);
+}
+
+void Calendar::addRecurringEvent(std::shared_ptr<Event> master, const RecurrenceRule& rule) {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::ADD_EVENT);
+    master->setTitle(strings.intern(master->getTitleHandle()));
+    master->setDescription(strings.intern(master->getDescriptionHandle()));
+    recurring.push_back({ std::move(master), rule });
+    queryCache.clear();
+}
+
+void Calendar::removeRecurringEvent(const Event& master) {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::REMOVE_EVENT);
+    CALENDAR_METRICS_SCANNED(recurring.size());
+    recurring.erase(std::remove_if(recurring.begin(), recurring.end(),
+        [&master](const RecurringSeries& series) {
+            return *series.master == master;
+        }), recurring.end());
+    queryCache.clear();
+}
+
+std::vector<std::shared_ptr<const Event>> Calendar::getOccurrences(const Date& start, const Date& end) const {
+    std::vector<std::shared_ptr<const Event>> result;
+    for (const auto& series : recurring) {
+        for (const Date& date : series.rule.occurrences(series.master->getDate(), start, end)) {
+            auto occurrence = std::make_shared<Event>(*series.master);
+            occurrence->setDate(date);
+            result.push_back(std::move(occurrence));
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(),
+        [](const std::shared_ptr<const Event>& a, const std::shared_ptr<const Event>& b) {
+            return a->sortKey() < b->sortKey();
+        });
+    return result;
+}
+
+void Calendar::indexEvent(const std::shared_ptr<const Event>& event) {
+    index.emplace(event->sortKey(), event);
+    statistics.add(*event);
+    textIndex.add(event);
+    titleIndex.add(event->getTitle());
+    queryCache.touch(*event);
+}
+
+void Calendar::unindexEvent(const std::shared_ptr<const Event>& event) {
+    auto range = index.equal_range(event->sortKey());
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == event) {
+            index.erase(it);
+            statistics.remove(*event);
+            textIndex.remove(event);
+            titleIndex.remove(event->getTitle());
+            queryCache.touch(*event);
+            return;
+        }
     }
 }
 
@@ -89,8 +390,8 @@ void Calendar::previousYear() {
     currentDate = Date(currentDate.getDay(), currentDate.getMonth(), currentDate.getYear() - 1);
 }
 
-std::vector<std::shared_ptr<Event>> Calendar::filterEvents(std::function<bool(const Event&)> predicate) const {
-    std::vector<std::shared_ptr<Event>> result;
+std::vector<std::shared_ptr<const Event>> Calendar::filterEvents(std::function<bool(const Event&)> predicate) const {
+    std::vector<std::shared_ptr<const Event>> result;
     for (const auto& event : events) {
         if (predicate(*event)) {
             result.push_back(event);
@@ -99,175 +400,615 @@ std::vector<std::shared_ptr<Event>> Calendar::filterEvents(std::function<bool(co
     return result;
 }
 
-std::vector<std::shared_ptr<Event>> Calendar::getEventsForDay(const Date& date) const {
-    return filterEvents([&date](const Event& event) {
+std::vector<std::shared_ptr<const Event>> Calendar::selectEvents(const ColumnFilter& filter) const {
+    std::vector<std::shared_ptr<const Event>> result;
+    std::vector<std::uint32_t> rows = columns.select(filter);
+    result.reserve(rows.size());
+    for (std::uint32_t row : rows) {
+        result.push_back(events[row]);
+    }
+    return result;
+}
+
+std::vector<std::shared_ptr<const Event>> Calendar::getEventsForDay(const Date& date) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::GET_EVENTS_FOR_DAY);
+    QueryKey key{ QueryKind::DAY, date.toSerial(), date.toSerial() };
+    std::vector<std::shared_ptr<const Event>> result;
+    if (queryCache.find(key, result)) {
+        CALENDAR_METRICS_RETURNED(result.size());
+        return result;
+    }
+
+    ColumnFilter filter;
+    filter.firstDay = filter.lastDay = date.toSerial();
+    result = columnar ? selectEvents(filter) : filterEvents([&date](const Event& event) {
         return event.getDate() == date;
         });
+    auto archived = archive.getEventsInDateRange(date, date);
+    result.insert(result.begin(), std::make_move_iterator(archived.begin()), std::make_move_iterator(archived.end()));
+    auto occurrences = getOccurrences(date, date);
+    result.insert(result.end(), std::make_move_iterator(occurrences.begin()), std::make_move_iterator(occurrences.end()));
+    queryCache.store(key, result);
+    CALENDAR_METRICS_SCANNED(events.size());
+    CALENDAR_METRICS_RETURNED(result.size());
+    return result;
 }
 
-std::vector<std::shared_ptr<Event>> Calendar::getEventsForMonth(int month, int year) const {
-    return filterEvents([month, year](const Event& event) {
+std::vector<std::shared_ptr<const Event>> Calendar::getEventsForMonth(int month, int year) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::GET_EVENTS_FOR_MONTH);
+    ColumnFilter filter;
+    filter.firstDay = Date(1, month, year).toSerial();
+    filter.lastDay = Date(getDaysInMonth(month, year), month, year).toSerial();
+    QueryKey key{ QueryKind::MONTH, filter.firstDay, filter.lastDay };
+    std::vector<std::shared_ptr<const Event>> result;
+    if (month >= 1 && month <= 12 && queryCache.find(key, result)) {
+        CALENDAR_METRICS_RETURNED(result.size());
+        return result;
+    }
+
+    result = columnar && month >= 1 && month <= 12 ? selectEvents(filter) : filterEvents([month, year](const Event& event) {
         return event.getDate().getMonth() == month && event.getDate().getYear() == year;
         });
+    if (month >= 1 && month <= 12) {
+        auto archived = archive.getEventsInDateRange(Date(1, month, year), Date(getDaysInMonth(month, year), month, year));
+        result.insert(result.begin(), std::make_move_iterator(archived.begin()), std::make_move_iterator(archived.end()));
+        auto occurrences = getOccurrences(Date(1, month, year), Date(getDaysInMonth(month, year), month, year));
+        result.insert(result.end(), std::make_move_iterator(occurrences.begin()), std::make_move_iterator(occurrences.end()));
+        queryCache.store(key, result);
+    }
+    CALENDAR_METRICS_SCANNED(events.size());
+    CALENDAR_METRICS_RETURNED(result.size());
+    return result;
 }
 
-std::vector<std::shared_ptr<Event>> Calendar::getEventsInDateRange(const Date& start, const Date& end) const {
-    return filterEvents([&start, &end](const Event& event) {
+std::vector<std::shared_ptr<const Event>> Calendar::getEventsForWeek(int week, int weekYear) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::GET_EVENTS_FOR_WEEK);
+    Date monday = Date::fromIsoWeek(weekYear, week);
+    QueryKey key{ QueryKind::WEEK, monday.toSerial(), monday.toSerial() + 6 };
+    std::vector<std::shared_ptr<const Event>> result;
+    if (queryCache.find(key, result)) {
+        CALENDAR_METRICS_RETURNED(result.size());
+        return result;
+    }
+
+    result = collectEvents(monday, monday + 6);
+    queryCache.store(key, result);
+    CALENDAR_METRICS_SCANNED(result.size());
+    CALENDAR_METRICS_RETURNED(result.size());
+    return result;
+}
+
+std::vector<std::shared_ptr<const Event>> Calendar::getEventsInDateRange(const Date& start, const Date& end) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::GET_EVENTS_IN_DATE_RANGE);
+    ColumnFilter filter;
+    filter.firstDay = start.toSerial();
+    filter.lastDay = end.toSerial();
+    QueryKey key{ QueryKind::RANGE, filter.firstDay, filter.lastDay };
+    std::vector<std::shared_ptr<const Event>> result;
+    if (!(end < start) && queryCache.find(key, result)) {
+        CALENDAR_METRICS_RETURNED(result.size());
+        return result;
+    }
+
+    result = columnar ? selectEvents(filter) : filterEvents([&start, &end](const Event& event) {
         return event.getDate() >= start && event.getDate() <= end;
         });
+    auto archived = archive.getEventsInDateRange(start, end);
+    result.insert(result.begin(), std::make_move_iterator(archived.begin()), std::make_move_iterator(archived.end()));
+    auto occurrences = getOccurrences(start, end);
+    result.insert(result.end(), std::make_move_iterator(occurrences.begin()), std::make_move_iterator(occurrences.end()));
+    if (!(end < start)) {
+        queryCache.store(key, result);
+    }
+    CALENDAR_METRICS_SCANNED(events.size());
+    CALENDAR_METRICS_RETURNED(result.size());
+    return result;
 }
 
-std::vector<std::shared_ptr<Event>> Calendar::getEventsByType(EventType type) const {
-    return filterEvents([type](const Event& event) {
+std::vector<std::shared_ptr<const Event>> Calendar::getEventsByType(EventType type) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::GET_EVENTS_BY_TYPE);
+    QueryKey key{ QueryKind::TYPE, static_cast<int>(type), 0 };
+    std::vector<std::shared_ptr<const Event>> result;
+    if (queryCache.find(key, result)) {
+        CALENDAR_METRICS_RETURNED(result.size());
+        return result;
+    }
+
+    ColumnFilter filter;
+    filter.type = type;
+    result = columnar ? selectEvents(filter) : filterEvents([type](const Event& event) {
         return event.getType() == type;
         });
+    queryCache.store(key, result);
+    CALENDAR_METRICS_SCANNED(events.size());
+    CALENDAR_METRICS_RETURNED(result.size());
+    return result;
 }
 
-std::vector<std::shared_ptr<Event>> Calendar::getEventsByPriority(EventPriority priority) const {
-    return filterEvents([priority](const Event& event) {
+std::vector<std::shared_ptr<const Event>> Calendar::getEventsByPriority(EventPriority priority) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::GET_EVENTS_BY_PRIORITY);
+    QueryKey key{ QueryKind::PRIORITY, static_cast<int>(priority), 0 };
+    std::vector<std::shared_ptr<const Event>> result;
+    if (queryCache.find(key, result)) {
+        CALENDAR_METRICS_RETURNED(result.size());
+        return result;
+    }
+
+    ColumnFilter filter;
+    filter.priority = priority;
+    result = columnar ? selectEvents(filter) : filterEvents([priority](const Event& event) {
         return event.getPriority() == priority;
         });
+    queryCache.store(key, result);
+    CALENDAR_METRICS_SCANNED(events.size());
+    CALENDAR_METRICS_RETURNED(result.size());
+    return result;
 }
 
-std::string Calendar::displayMonth() const {
-    std::ostringstream oss;
-    int month = currentDate.getMonth();
-    int year = currentDate.getYear();
+EventCursor Calendar::getEventCursor(const Date& start, const Date& end) const {
+    auto first = index.lower_bound({ start.toSerial(), std::numeric_limits<int>::min() });
+    auto last = index.upper_bound({ end.toSerial(), std::numeric_limits<int>::max() });
+    if (end < start) {
+        last = first;
+    }
+    return EventCursor(first, last);
+}
 
-    oss << "\n" << getMonthName(month) << " " << year << "\n";
-    oss << "Mo Tu We Th Fr Sa Su\n";
+EventCursor Calendar::getEventsFrom(const Date& date, const Time& time) const {
+    return EventCursor(index.lower_bound({ date.toSerial(), time.toSeconds() }), index.end());
+}
 
-    int firstDay = getDayOfWeek(1, month, year);
-    int daysInMonth = getDaysInMonth(month, year);
+std::vector<std::shared_ptr<const Event>> Calendar::getUpcomingEvents(size_t count) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::GET_UPCOMING_EVENTS);
+    std::vector<std::shared_ptr<const Event>> result;
+    MergedEventCursor cursor = getMergedCursor(currentDate, Date(31, 12, 9999));
 
-    for (int i = 1; i < firstDay; ++i) {
-        oss << "   ";
+    while (result.size() < count && cursor.hasNext()) {
+        result.push_back(cursor.next());
     }
 
-    for (int day = 1; day <= daysInMonth; ++day) {
-        oss << std::setw(2) << day << " ";
+    CALENDAR_METRICS_SCANNED(result.size());
+    CALENDAR_METRICS_RETURNED(result.size());
+    return result;
+}
+
+std::vector<std::shared_ptr<const Event>> Calendar::getTopPriorityEvents(const Date& start, const Date& end, size_t count) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::GET_TOP_PRIORITY_EVENTS);
 
-        Date checkDate(day, month, year);
-        auto dayEvents = getEventsForDay(checkDate);
+    struct Candidate {
+        EventKey key;
+        std::shared_ptr<const Event> event;
+    };
 
-        if (checkDate == currentDate) {
-            oss << "*";
+    // Heap ordering puts the weakest kept candidate on top
+    auto better = [](const Candidate& a, const Candidate& b) {
+        if (a.event->getPriority() != b.event->getPriority()) {
+            return a.event->getPriority() > b.event->getPriority();
         }
-        else if (!dayEvents.empty()) {
-            bool hasHighPriority = false;
-            for (const auto& event : dayEvents) {
-                if (event->getPriority() == EventPriority::HIGH ||
-                    event->getPriority() == EventPriority::URGENT) {
-                    hasHighPriority = true;
-                    break;
-                }
-            }
+        return a.key < b.key;
+    };
+
+    if (count == 0) {
+        return {};
+    }
+
+    std::vector<Candidate> heap;
+    heap.reserve(count);
 
-            if (hasHighPriority) {
-                oss << "!!";
+    size_t scanned = 0;
+    MergedEventCursor cursor = getMergedCursor(start, end);
+    while (cursor.hasNext()) {
+        ++scanned;
+        EventKey key = cursor.peekKey();
+        Candidate candidate{ key, cursor.next() };
+
+        if (heap.size() < count) {
+            heap.push_back(std::move(candidate));
+            std::push_heap(heap.begin(), heap.end(), better);
+        }
+        else if (better(candidate, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), better);
+            heap.back() = std::move(candidate);
+            std::push_heap(heap.begin(), heap.end(), better);
+        }
+    }
+
+    std::sort_heap(heap.begin(), heap.end(), better);
+    CALENDAR_METRICS_SCANNED(scanned);
+    CALENDAR_METRICS_RETURNED(heap.size());
+
+    std::vector<std::shared_ptr<const Event>> result;
+    result.reserve(heap.size());
+    for (auto& candidate : heap) {
+        result.push_back(std::move(candidate.event));
+    }
+    return result;
+}
+
+size_t Calendar::countEvents(const Date& start, const Date& end) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::COUNT_EVENTS);
+    return statistics.count(start, end);
+}
+
+size_t Calendar::countEventsForWeek(int week, int weekYear) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::COUNT_EVENTS);
+    Date monday = Date::fromIsoWeek(weekYear, week);
+    return statistics.count(monday, monday + 6);
+}
+
+size_t Calendar::countEventsByType(EventType type, const Date& start, const Date& end) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::COUNT_EVENTS);
+    return statistics.countByType(type, start, end);
+}
+
+size_t Calendar::countEventsByPriority(EventPriority priority, const Date& start, const Date& end) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::COUNT_EVENTS);
+    return statistics.countByPriority(priority, start, end);
+}
+
+std::array<size_t, EventStatistics::HOURS> Calendar::getHourlyEventCounts(const Date& start, const Date& end) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::COUNT_EVENTS);
+    return statistics.countByHour(start, end);
+}
+
+std::vector<std::shared_ptr<const Event>> Calendar::searchEvents(const SearchQuery& query) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::SEARCH_EVENTS);
+    std::vector<std::shared_ptr<const Event>> result = textIndex.search(query);
+
+    std::stable_sort(result.begin(), result.end(),
+        [](const std::shared_ptr<const Event>& a, const std::shared_ptr<const Event>& b) {
+            return a->sortKey() < b->sortKey();
+        });
+
+    CALENDAR_METRICS_RETURNED(result.size());
+    return result;
+}
+
+std::vector<std::string> Calendar::completeTitle(std::string_view prefix, size_t count) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::COMPLETE_TITLE);
+    std::vector<std::string> result = titleIndex.complete(prefix, count);
+    CALENDAR_METRICS_RETURNED(result.size());
+    return result;
+}
+
+void Calendar::markEventDays(int month, int year, unsigned char (&marks)[32]) const {
+    std::fill(std::begin(marks), std::end(marks), 0);
+
+    auto markDay = [&marks](int day, EventPriority priority) {
+        unsigned char& mark = marks[day];
+
+        if (priority == EventPriority::HIGH || priority == EventPriority::URGENT) {
+            mark = 2;
+        }
+        else if (mark == 0) {
+            mark = 1;
+        }
+    };
+
+    Date first(1, month, year);
+    Date last(getDaysInMonth(month, year), month, year);
+
+    EventCursor cursor = getEventCursor(first, last);
+    while (cursor.hasNext()) {
+        std::shared_ptr<const Event> event = cursor.next();
+        markDay(event->getDate().getDay(), event->getPriority());
+    }
+
+    for (const auto& series : recurring) {
+        for (const Date& date : series.rule.occurrences(series.master->getDate(), first, last)) {
+            markDay(date.getDay(), series.master->getPriority());
+        }
+    }
+
+    if (archive.size() > 0) {
+        for (const auto& event : archive.getEventsInDateRange(first, last)) {
+            markDay(event->getDate().getDay(), event->getPriority());
+        }
+    }
+}
+
+std::string Calendar::displayWeek() const {
+    std::string result;
+    StringSink sink(result);
+    renderWeek(currentDate.getIsoWeek(), currentDate.getIsoWeekYear(), sink);
+    return result;
+}
+
+std::string Calendar::displayMonth() const {
+    std::string result;
+    StringSink sink(result);
+    renderMonth(currentDate.getMonth(), currentDate.getYear(), sink);
+    return result;
+}
+
+std::string Calendar::displayYear() const {
+    std::string result;
+    StringSink sink(result);
+    renderYear(currentDate.getYear(), sink);
+    return result;
+}
+
+size_t Calendar::estimateMonthSize(int month, int year) const {
+    const size_t gridSize = 64 + 31 * 6 + 7 * 3;
+    const size_t eventLineSize = 64;
+    return gridSize + eventLineSize * statistics.count(Date(1, month, year), Date(getDaysInMonth(month, year), month, year));
+}
+
+size_t Calendar::estimateYearSize(int year) const {
+    (void)year;
+    const size_t rowHeaderSize = 3 * 23 + 1;
+    const size_t weekLineSize = 3 * (7 * 4 + 2) + 1;
+    return 16 + 4 * (2 * rowHeaderSize + 6 * weekLineSize);
+}
+
+void Calendar::renderWeek(int week, int weekYear, OutputSink& sink) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::RENDER_WEEK);
+    static const char* const dayNames[] = { "Mo", "Tu", "We", "Th", "Fr", "Sa", "Su" };
+
+    Date monday = Date::fromIsoWeek(weekYear, week);
+    std::vector<std::shared_ptr<const Event>> weekEvents = collectEvents(monday, monday + 6);
+    auto next = weekEvents.begin();
+
+    SinkWriter out(sink);
+    out.write("\nWeek ", 6);
+    out.number(monday.getIsoWeek());
+    out.write(" of ", 4);
+    out.number(monday.getIsoWeekYear());
+    out.put('\n');
+
+    for (int weekday = 0; weekday < 7; ++weekday) {
+        Date day = monday + weekday;
+        out.write(dayNames[weekday], 2);
+        out.put(' ');
+        out.write(day.toString());
+        if (day == currentDate) {
+            out.write(" *", 2);
+        }
+        out.put('\n');
+
+        for (; next != weekEvents.end() && (*next)->getDate() == day; ++next) {
+            const Event& event = **next;
+            out.write("   ", 3);
+            if (event.hasTime()) {
+                out.write(event.getTime()->toString());
             }
             else {
-                oss << "!";
+                out.write("all day ", 8);
             }
+            out.write(" - ", 3);
+            out.write(event.getTitle());
+            out.write(" [", 2);
+            out.write(Event::priorityToString(event.getPriority()));
+            out.write("]\n", 2);
+        }
+    }
+    out.flush();
+}
+
+void Calendar::renderMonth(int month, int year, OutputSink& sink) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::RENDER_MONTH);
+    sink.reserve(estimateMonthSize(month, year));
+    SinkWriter out(sink);
+
+    out.put('\n');
+    out.write(getMonthName(month));
+    out.put(' ');
+    out.number(year);
+    out.write("\nMo Tu We Th Fr Sa Su\n", 22);
+
+    int firstDay = getDayOfWeek(1, month, year);
+    int daysInMonth = getDaysInMonth(month, year);
+
+    unsigned char marks[32];
+    markEventDays(month, year, marks);
+
+    out.repeat(' ', 3 * static_cast<size_t>(firstDay - 1));
+
+    for (int day = 1; day <= daysInMonth; ++day) {
+        out.number(day, 2);
+        out.put(' ');
+
+        if (day == currentDate.getDay() && month == currentDate.getMonth() && year == currentDate.getYear()) {
+            out.put('*');
+        }
+        else if (marks[day] == 2) {
+            out.write("!!", 2);
+        }
+        else if (marks[day] == 1) {
+            out.put('!');
         }
         else {
-            oss << " ";
+            out.put(' ');
         }
 
         if ((firstDay + day - 1) % 7 == 0) {
-            oss << "\n";
+            out.put('\n');
         }
     }
 
-    oss << "\n";
+    out.put('\n');
 
-    auto monthEvents = getEventsForMonth(month, year);
+    std::vector<std::shared_ptr<const Event>> monthEvents = collectEvents(Date(1, month, year), Date(daysInMonth, month, year));
     if (!monthEvents.empty()) {
-        oss << "\nEvents this month:\n";
+        out.write("\nEvents this month:\n", 20);
         for (const auto& event : monthEvents) {
-            oss << event->getDate() << " - " << event->getTitle();
+            out.write(event->getDate().toString());
+            out.write(" - ", 3);
+            out.write(event->getTitle());
             if (event->hasTime()) {
-                oss << " at " << event->getTime().value();
+                out.write(" at ", 4);
+                out.write(event->getTime()->toString());
             }
-            oss << " [" << Event::priorityToString(event->getPriority()) << "]\n";
+            out.write(" [", 2);
+            out.write(Event::priorityToString(event->getPriority()));
+            out.write("]\n", 2);
         }
     }
-
-    return oss.str();
+    out.flush();
 }
 
-std::string Calendar::displayYear() const {
-    std::ostringstream oss;
-    int year = currentDate.getYear();
+void Calendar::renderYear(int year, OutputSink& sink) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::RENDER_YEAR);
+    sink.reserve(estimateYearSize(year));
+    SinkWriter out(sink);
 
-    oss << "\n" << year << "\n\n";
+    out.put('\n');
+    out.number(year);
+    out.write("\n\n", 2);
 
     for (int row = 0; row < 4; ++row) {
+        int firstDays[3];
+        int daysInMonths[3];
+        unsigned char marks[3][32];
+
         for (int col = 0; col < 3; ++col) {
             int month = row * 3 + col + 1;
-            oss << std::setw(10) << getMonthName(month).substr(0, 3) << "          ";
+            firstDays[col] = getDayOfWeek(1, month, year);
+            daysInMonths[col] = getDaysInMonth(month, year);
+            markEventDays(month, year, marks[col]);
+
+            std::string shortName = getMonthName(month).substr(0, 3);
+            out.repeat(' ', 10 - shortName.size());
+            out.write(shortName);
+            out.repeat(' ', 10);
         }
-        oss << "\n";
+        out.put('\n');
 
         for (int col = 0; col < 3; ++col) {
-            oss << "Mo Tu We Th Fr Sa Su   ";
+            out.write("Mo Tu We Th Fr Sa Su   ", 23);
         }
-        oss << "\n";
+        out.put('\n');
 
         int maxWeeks = 6;
 
         for (int week = 0; week < maxWeeks; ++week) {
             for (int col = 0; col < 3; ++col) {
                 int month = row * 3 + col + 1;
-                int firstDay = getDayOfWeek(1, month, year);
-                int daysInMonth = getDaysInMonth(month, year);
 
                 for (int weekDay = 1; weekDay <= 7; ++weekDay) {
-                    int day = week * 7 + weekDay - firstDay + 1;
+                    int day = week * 7 + weekDay - firstDays[col] + 1;
 
-                    if (day > 0 && day <= daysInMonth) {
-                        Date checkDate(day, month, year);
-                        oss << std::setw(2) << day;
+                    if (day > 0 && day <= daysInMonths[col]) {
+                        out.number(day, 2);
 
-                        if (checkDate == currentDate) {
-                            oss << "*";
+                        if (day == currentDate.getDay() && month == currentDate.getMonth() && year == currentDate.getYear()) {
+                            out.put('*');
+                        }
+                        else if (marks[col][day] == 2) {
+                            out.write("!!", 2);
+                        }
+                        else if (marks[col][day] == 1) {
+                            out.put('!');
                         }
                         else {
-                            auto dayEvents = getEventsForDay(checkDate);
-                            if (!dayEvents.empty()) {
-                                bool hasHighPriority = false;
-                                for (const auto& event : dayEvents) {
-                                    if (event->getPriority() == EventPriority::HIGH ||
-                                        event->getPriority() == EventPriority::URGENT) {
-                                        hasHighPriority = true;
-                                        break;
-                                    }
-                                }
-
-                                if (hasHighPriority) {
-                                    oss << "!!";
-                                }
-                                else {
-                                    oss << "!";
-                                }
-                            }
-                            else {
-                                oss << " ";
-                            }
+                            out.put(' ');
                         }
                     }
                     else {
-                        oss << "   ";
+                        out.write("   ", 3);
                     }
                 }
 
-                oss << "  ";
+                out.write("  ", 2);
+            }
+            out.put('\n');
+        }
+    }
+    out.flush();
+}
+
+void Calendar::renderYears(int firstYear, int lastYear, OutputSink& sink, unsigned threads) const {
+    CALENDAR_METRICS_SCOPE(CalendarOperation::RENDER_YEARS);
+    if (lastYear < firstYear) {
+        return;
+    }
+
+    size_t taskCount = static_cast<size_t>(lastYear - firstYear) + 1;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t workerCount = std::min<size_t>(threads, taskCount);
+
+    struct Task {
+        std::string text;
+        bool done = false;
+    };
+
+    std::vector<Task> tasks(taskCount);
+    std::atomic<size_t> nextTask{ 0 };
+    std::atomic<bool> stopped{ false };
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr failure;
+
+    auto work = [&]() {
+        for (size_t i = nextTask++; i < taskCount && !stopped; i = nextTask++) {
+            std::string text;
+            try {
+                StringSink taskSink(text);
+                renderYear(firstYear + static_cast<int>(i), taskSink);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+                stopped = true;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks[i].text = std::move(text);
+            tasks[i].done = true;
+            finished.notify_all();
+        }
+    };
+
+    // Workers stop between years and are joined on every way out, including a throwing sink
+    std::vector<std::thread> workers;
+    auto stopWorkers = [&]() {
+        stopped = true;
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    };
+
+    try {
+        workers.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers.emplace_back(work);
+        }
+
+        sink.reserve(estimateYearSize(firstYear) * taskCount);
+        for (size_t i = 0; i < taskCount; ++i) {
+            std::string text;
+            {
+                // A failed worker stops the others, so later years may never be rendered
+                std::unique_lock<std::mutex> lock(mutex);
+                finished.wait(lock, [&tasks, &failure, i] { return tasks[i].done || failure; });
+                if (failure) {
+                    break;
+                }
+                text = std::move(tasks[i].text);
             }
-            oss << "\n";
+            sink.write(text.data(), text.size());
         }
     }
+    catch (...) {
+        stopWorkers();
+        throw;
+    }
+    stopWorkers();
 
-    return oss.str();
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+std::string Calendar::renderYears(int firstYear, int lastYear, unsigned threads) const {
+    std::string result;
+    StringSink sink(result);
+    renderYears(firstYear, lastYear, sink, threads);
+    return result;
 }
 
 
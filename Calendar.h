@@ -3,14 +3,98 @@
 
 #include "Date.h"
 #include "Event.h"
+#include "CalendarMetrics.h"
+#include "ColumnarEventStore.h"
+#include "EventArchive.h"
+#include "EventStore.h"
+#include "EventStatistics.h"
+#include "EventTextIndex.h"
+#include "TitleIndex.h"
+#include "OutputSink.h"
+#include "QueryCache.h"
+#include "Recurrence.h"
 #include <vector>
 #include <map>
 #include <functional>
 #include <memory>
+#include <optional>
+
+// Events ordered by date and time. Stored events are handed out as const: changing one in
+// place would desynchronize every index keyed on it, so edits go through remove and add.
+using EventIndex = std::multimap<EventKey, std::shared_ptr<const Event>>;
+
+// Lazy forward walk over a slice of a calendar's index.
+// Invalidated by adding or removing events in that calendar.
+class EventCursor {
+private:
+    EventIndex::const_iterator current;
+    EventIndex::const_iterator last;
+
+public:
+    EventCursor(EventIndex::const_iterator first, EventIndex::const_iterator end)
+        : current(first), last(end) {}
+
+    bool hasNext() const { return current != last; }
+    const EventKey& peekKey() const { return current->first; }
+    const std::shared_ptr<const Event>& peek() const { return current->second; }
+    std::shared_ptr<const Event> next() { return (current++)->second; }
+};
+
+class Calendar;
+
+// Lazy walk over everything a calendar shows in a date window: hot events, archived events
+// decoded a segment at a time, and recurring occurrences expanded a few weeks at a time.
+// On equal keys archived events come first, then occurrences, then hot events.
+// Invalidated by changing the calendar.
+class MergedEventCursor {
+private:
+    enum class Source { HOT, ARCHIVED, RECURRING };
+
+    // Occurrence windows start at this many days and widen while they come up empty
+    static constexpr int OCCURRENCE_WINDOW = 64;
+
+    const Calendar* calendar;
+    EventCursor hot;
+    EventArchive::Cursor archived;
+    std::vector<std::shared_ptr<const Event>> occurrences;
+    size_t occurrence = 0;
+    int expandedDay;            // last day whose occurrences are in `occurrences` or behind
+    int lastDay;
+    int window = OCCURRENCE_WINDOW;
+
+    MergedEventCursor(const Calendar& calendar, const Date& start, const Date& end);
+
+    void expand();
+    Source head() const;
+
+public:
+    bool hasNext() const { return hot.hasNext() || archived.hasNext() || occurrence < occurrences.size(); }
+    EventKey peekKey() const { return peek()->sortKey(); }
+    const std::shared_ptr<const Event>& peek() const;
+    std::shared_ptr<const Event> next();
+
+    friend class Calendar;
+};
 
 class Calendar {
 private:
-    std::vector<std::shared_ptr<Event>> events;
+    struct RecurringSeries {
+        std::shared_ptr<const Event> master;
+        RecurrenceRule rule;
+    };
+
+    std::vector<std::shared_ptr<const Event>> events;
+    std::vector<RecurringSeries> recurring;
+    EventColumns columns;
+    bool columnar = false;
+    EventArchive archive;
+    EventIndex index;
+    EventStatistics statistics;
+    EventTextIndex textIndex;
+    TitleIndex titleIndex;
+    StringPool strings;
+    mutable QueryCache queryCache;
+    std::optional<CalendarHistory> history;
     Date currentDate; 
 
     int getDayOfWeek(int day, int month, int year) const;
@@ -19,31 +103,148 @@ private:
     std::string getMonthName(int month) const;
 
    
-    std::vector<std::shared_ptr<Event>> filterEvents(std::function<bool(const Event&)> predicate) const;
+    std::vector<std::shared_ptr<const Event>> filterEvents(std::function<bool(const Event&)> predicate) const;
+    std::vector<std::shared_ptr<const Event>> selectEvents(const ColumnFilter& filter) const;
+    // Hot, archived and recurring events within [start, end], in date and time order
+    std::vector<std::shared_ptr<const Event>> collectEvents(const Date& start, const Date& end) const;
+
+    // Per-day markers for a month: 0 none, 1 events, 2 high-priority events
+    void markEventDays(int month, int year, unsigned char (&marks)[32]) const;
+
+    void indexEvent(const std::shared_ptr<const Event>& event);
+    void unindexEvent(const std::shared_ptr<const Event>& event);
+    // Moves the calendar to a kept version of its history, touching only the events that differ
+    void restoreVersion(const EventStore& target);
+
+    friend class MergedEventCursor;
 
 public:
    
     Calendar(const Date& date = Date());
 
     void addEvent(const Event& event);
+    void addEvent(Event&& event);
+    // The calendar may intern the event's text; the caller must not change it afterwards
     void addEvent(std::shared_ptr<Event> event);
+
+    // Constructs the event directly in its shared allocation
+    template <typename... Args>
+    std::shared_ptr<const Event> emplaceEvent(Args&&... args) {
+        std::shared_ptr<Event> event = std::make_shared<Event>(std::forward<Args>(args)...);
+        addEvent(event);
+        return event;
+    }
     void removeEvent(const Event& event);
 
+    // Serve the date, type and priority queries from packed columns instead of walking
+    // the events; costs about 6 bytes per event
+    void setColumnarScans(bool enabled);
+    bool hasColumnarScans() const { return columnar; }
+
+    // Moves single events dated before `cutoff` into compressed cold segments and returns
+    // how many were moved. Day, month and range queries, merged cursors, rendering and the
+    // calendar exports (EventFormats.h) still show them, decoding only the segments that
+    // overlap the window, and counts still include them; EventCursor, type/priority queries,
+    // search, autocomplete and removeEvent see hot events only.
+    size_t archiveBefore(const Date& cutoff);
+    size_t getArchivedEventCount() const { return archive.size(); }
+    // Decoded copies of every archived event in date and time order
+    std::vector<std::shared_ptr<const Event>> getArchivedEvents() const { return archive.getAllEvents(); }
+
+    // Caches day, week, month, range, type and priority results within `bytes` (0, the
+    // default, disables it). The budget covers pointer storage, plus the occurrence and
+    // archive copies that only the cache keeps alive. Adding or removing an event only drops
+    // cached results for its month, type and priority; archiving and recurring series drop
+    // everything. Results served from the cache hold the same copies as before.
+    void setQueryCacheBudget(size_t bytes);
+    QueryCache::Stats getQueryCacheStats() const { return queryCache.getStats(); }
+
+    // Keeps up to `versions` versions of the single hot events (0, the default, disables it):
+    // each addEvent or removeEvent that changes them makes a version sharing all untouched
+    // structure with the previous one, O(log n) memory per change. Recurring series are not
+    // versioned, and archiveBefore starts the history over from the remaining hot events.
+    void setHistoryLimit(size_t versions);
+    size_t getHistoryLimit() const { return history ? history->getLimit() : 0; }
+    size_t getVersion() const { return history ? history->version() : 0; }
+    // Single hot events as of a kept version, without copying the calendar. Throws
+    // std::out_of_range for versions not kept, and std::logic_error while history is disabled.
+    EventStore getSnapshot() const { return getSnapshot(getVersion()); }
+    EventStore getSnapshot(size_t version) const;
+
+    bool canUndo() const { return history && history->canUndo(); }
+    bool canRedo() const { return history && history->canRedo(); }
+    // Step the single events one version back or forward; return false if there is none
+    bool undo();
+    bool redo();
+
+    // The master's date is the first day of the series. Occurrences are expanded on demand
+    // by the date-bounded queries (day, month, range), merged cursors, the agenda queries and
+    // displayMonth/displayYear; type/priority queries, EventCursor, counts and search cover
+    // single events only.
+    void addRecurringEvent(const Event& master, const RecurrenceRule& rule);
+    void addRecurringEvent(std::shared_ptr<Event> master, const RecurrenceRule& rule);
+    void removeRecurringEvent(const Event& master);
+
+    // Occurrences within [start, end] as standalone copies of their masters, in date and time order
+    std::vector<std::shared_ptr<const Event>> getOccurrences(const Date& start, const Date& end) const;
+
     void nextMonth();
     void previousMonth();
     void nextYear();
     void previousYear();
 
     
+    std::string displayWeek() const;
     std::string displayMonth() const;
     std::string displayYear() const;
 
+    // Same text as displayMonth/displayYear, written straight into a sink
+    void renderWeek(int week, int weekYear, OutputSink& sink) const;
+    void renderMonth(int month, int year, OutputSink& sink) const;
+    void renderYear(int year, OutputSink& sink) const;
+    size_t estimateMonthSize(int month, int year) const;
+    size_t estimateYearSize(int year) const;
+
+    // Years rendered concurrently on `threads` workers (0 = hardware concurrency)
+    // and emitted in order; does not touch currentDate
+    void renderYears(int firstYear, int lastYear, OutputSink& sink, unsigned threads = 0) const;
+    std::string renderYears(int firstYear, int lastYear, unsigned threads = 0) const;
+
    
-    std::vector<std::shared_ptr<Event>> getEventsForDay(const Date& date) const;
-    std::vector<std::shared_ptr<Event>> getEventsForMonth(int month, int year) const;
-    std::vector<std::shared_ptr<Event>> getEventsInDateRange(const Date& start, const Date& end) const;
-    std::vector<std::shared_ptr<Event>> getEventsByType(EventType type) const;
-    std::vector<std::shared_ptr<Event>> getEventsByPriority(EventPriority priority) const;
+    std::vector<std::shared_ptr<const Event>> getEventsForDay(const Date& date) const;
+    std::vector<std::shared_ptr<const Event>> getEventsForMonth(int month, int year) const;
+    // ISO week; unlike the other getEventsFor* results these are in date and time order
+    std::vector<std::shared_ptr<const Event>> getEventsForWeek(int week, int weekYear) const;
+    std::vector<std::shared_ptr<const Event>> getEventsInDateRange(const Date& start, const Date& end) const;
+    std::vector<std::shared_ptr<const Event>> getEventsByType(EventType type) const;
+    std::vector<std::shared_ptr<const Event>> getEventsByPriority(EventPriority priority) const;
+
+    EventCursor getEventCursor(const Date& start, const Date& end) const;
+    EventCursor getAllEvents() const { return EventCursor(index.begin(), index.end()); }
+    // Hot, archived and recurring events within [start, end]
+    MergedEventCursor getMergedCursor(const Date& start, const Date& end) const { return MergedEventCursor(*this, start, end); }
+
+    // Agenda: events from a moment onward in date and time order
+    EventCursor getEventsFrom(const Date& date, const Time& time = Time()) const;
+    // Hot, archived and recurring events from the current date on
+    std::vector<std::shared_ptr<const Event>> getUpcomingEvents(size_t count) const;
+
+    // Highest priority first, earlier events first among equal priorities; includes
+    // archived events and recurring occurrences
+    std::vector<std::shared_ptr<const Event>> getTopPriorityEvents(const Date& start, const Date& end, size_t count) const;
+
+    // Range counts from incrementally maintained counters, without scanning events
+    size_t countEvents(const Date& start, const Date& end) const;
+    size_t countEventsForWeek(int week, int weekYear) const;
+    size_t countEventsByType(EventType type, const Date& start, const Date& end) const;
+    size_t countEventsByPriority(EventPriority priority, const Date& start, const Date& end) const;
+    std::array<size_t, EventStatistics::HOURS> getHourlyEventCounts(const Date& start, const Date& end) const;
+
+    // Keyword search over titles and descriptions, in date and time order
+    std::vector<std::shared_ptr<const Event>> searchEvents(const SearchQuery& query) const;
+
+    // Title autocomplete, most frequent first (at most 10 completions)
+    std::vector<std::string> completeTitle(std::string_view prefix, size_t count = 5) const;
 
    
     Date getCurrentDate() const { return currentDate; }
@@ -0,0 +1,216 @@
+#include "CalendarClient.h"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t READ_CHUNK = 64 * 1024;
+
+std::runtime_error systemError(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+}
+
+CalendarClient::CalendarClient(const std::string& socketPath) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Invalid socket path: " + socketPath);
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    socket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (socket < 0) {
+        throw systemError("Unable to create socket");
+    }
+    if (::connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        std::runtime_error error = systemError("Unable to connect to " + socketPath);
+        ::close(socket);
+        throw error;
+    }
+}
+
+CalendarClient::~CalendarClient() {
+    ::close(socket);
+}
+
+std::uint32_t CalendarClient::begin(RequestType type, ProtocolWriter& writer) {
+    std::uint32_t id = nextId++;
+    writer.beginFrame(static_cast<std::uint8_t>(type), id);
+    ++pending;
+    return id;
+}
+
+std::uint32_t CalendarClient::queueAddEvent(const Event& event) {
+    ProtocolWriter writer(output);
+    std::uint32_t id = begin(RequestType::ADD_EVENT, writer);
+    writer.event(event);
+    writer.endFrame();
+    return id;
+}
+
+std::uint32_t CalendarClient::queueRemoveEvent(const Event& event) {
+    ProtocolWriter writer(output);
+    std::uint32_t id = begin(RequestType::REMOVE_EVENT, writer);
+    EventKey key = event.sortKey();
+    writer.i32(key.first);
+    writer.i32(key.second);
+    writer.endFrame();
+    return id;
+}
+
+std::uint32_t CalendarClient::queueGetEventsInDateRange(const Date& start, const Date& end) {
+    ProtocolWriter writer(output);
+    std::uint32_t id = begin(RequestType::GET_EVENTS_IN_DATE_RANGE, writer);
+    writer.i32(start.toSerial());
+    writer.i32(end.toSerial());
+    writer.endFrame();
+    return id;
+}
+
+std::uint32_t CalendarClient::queueGetEventsByType(EventType type) {
+    ProtocolWriter writer(output);
+    std::uint32_t id = begin(RequestType::GET_EVENTS_BY_TYPE, writer);
+    writer.u8(static_cast<std::uint8_t>(type));
+    writer.endFrame();
+    return id;
+}
+
+std::uint32_t CalendarClient::queueGetEventsByPriority(EventPriority priority) {
+    ProtocolWriter writer(output);
+    std::uint32_t id = begin(RequestType::GET_EVENTS_BY_PRIORITY, writer);
+    writer.u8(static_cast<std::uint8_t>(priority));
+    writer.endFrame();
+    return id;
+}
+
+void CalendarClient::exchange(bool waitForInput) {
+    size_t sent = 0;
+    bool received = false;
+
+    while (sent < output.size() || (waitForInput && !received)) {
+        pollfd descriptor{};
+        descriptor.fd = socket;
+        descriptor.events = POLLIN | (sent < output.size() ? POLLOUT : 0);
+        if (::poll(&descriptor, 1, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw systemError("Connection failed");
+        }
+
+        if (descriptor.revents & POLLOUT) {
+            ssize_t written = ::send(socket, output.data() + sent, output.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                throw systemError("Connection failed");
+            }
+            sent += written > 0 ? static_cast<size_t>(written) : 0;
+        }
+        if (descriptor.revents & (POLLIN | POLLHUP | POLLERR)) {
+            size_t used = input.size();
+            input.resize(used + READ_CHUNK);
+            ssize_t count = ::recv(socket, &input[used], READ_CHUNK, MSG_DONTWAIT);
+            input.resize(used + (count > 0 ? static_cast<size_t>(count) : 0));
+            if (count == 0) {
+                throw std::runtime_error("Connection closed by server");
+            }
+            if (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                throw systemError("Connection failed");
+            }
+            received = received || count > 0;
+        }
+    }
+    output.clear();
+}
+
+void CalendarClient::flush() {
+    if (!output.empty()) {
+        exchange(false);
+    }
+}
+
+CalendarClient::Response CalendarClient::receive() {
+    if (pending == 0) {
+        throw std::runtime_error("No request awaiting a response");
+    }
+    flush();
+
+    Frame frame;
+    while (!nextFrame(input, inputOffset, frame)) {
+        exchange(true);
+    }
+
+    Response response;
+    response.id = frame.id;
+    response.status = static_cast<ResponseStatus>(frame.code);
+    ProtocolReader reader(frame.body);
+    if (response.status == ResponseStatus::OK) {
+        response.count = reader.u32();
+        while (!reader.atEnd()) {
+            response.events.push_back(reader.event());
+        }
+    }
+    else {
+        response.error = std::string(reader.text());
+    }
+    --pending;
+
+    if (inputOffset == input.size()) {
+        input.clear();
+        inputOffset = 0;
+    }
+    else if (inputOffset > input.size() / 2) {
+        input.erase(0, inputOffset);
+        inputOffset = 0;
+    }
+    return response;
+}
+
+CalendarClient::Response CalendarClient::call() {
+    Response response;
+    do {
+        response = receive();
+    } while (pending > 0);
+
+    if (response.status != ResponseStatus::OK) {
+        throw std::runtime_error(response.error);
+    }
+    return response;
+}
+
+void CalendarClient::addEvent(const Event& event) {
+    queueAddEvent(event);
+    call();
+}
+
+size_t CalendarClient::removeEvent(const Event& event) {
+    queueRemoveEvent(event);
+    return call().count;
+}
+
+std::vector<Event> CalendarClient::getEventsInDateRange(const Date& start, const Date& end) {
+    queueGetEventsInDateRange(start, end);
+    return call().events;
+}
+
+std::vector<Event> CalendarClient::getEventsByType(EventType type) {
+    queueGetEventsByType(type);
+    return call().events;
+}
+
+std::vector<Event> CalendarClient::getEventsByPriority(EventPriority priority) {
+    queueGetEventsByPriority(priority);
+    return call().events;
+}
+
+#endif // __linux__
@@ -0,0 +1,63 @@
+#ifndef CALENDAR_CLIENT_H
+#define CALENDAR_CLIENT_H
+
+#include "CalendarProtocol.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Connection to a CalendarServer. The queue* calls only buffer a request and return its
+// id; flush() sends everything queued, and receive() returns responses in request order.
+// The plain calls below do one round trip each, dropping any responses still pending.
+class CalendarClient {
+public:
+    struct Response {
+        std::uint32_t id = 0;
+        ResponseStatus status = ResponseStatus::OK;
+        std::uint32_t count = 0;      // events added or removed, or events returned
+        std::vector<Event> events;
+        std::string error;
+    };
+
+private:
+    int socket = -1;
+    std::string output;
+    std::string input;
+    size_t inputOffset = 0;
+    std::uint32_t nextId = 1;
+    size_t pending = 0;
+
+    std::uint32_t begin(RequestType type, ProtocolWriter& writer);
+    // Sends while also reading, so a server blocked on its own output cannot deadlock us
+    void exchange(bool waitForInput);
+    Response call();
+
+public:
+    // Throws std::runtime_error if the server is not reachable
+    explicit CalendarClient(const std::string& socketPath);
+    ~CalendarClient();
+
+    CalendarClient(const CalendarClient&) = delete;
+    CalendarClient& operator=(const CalendarClient&) = delete;
+
+    std::uint32_t queueAddEvent(const Event& event);
+    // Removes every event with the same date and time, like Calendar::removeEvent
+    std::uint32_t queueRemoveEvent(const Event& event);
+    std::uint32_t queueGetEventsInDateRange(const Date& start, const Date& end);
+    std::uint32_t queueGetEventsByType(EventType type);
+    std::uint32_t queueGetEventsByPriority(EventPriority priority);
+
+    void flush();
+    // Blocks for the next response, flushing queued requests first
+    Response receive();
+    size_t pendingCount() const { return pending; }
+
+    // Throw std::runtime_error when the server answers with an error
+    void addEvent(const Event& event);
+    size_t removeEvent(const Event& event);
+    std::vector<Event> getEventsInDateRange(const Date& start, const Date& end);
+    std::vector<Event> getEventsByType(EventType type);
+    std::vector<Event> getEventsByPriority(EventPriority priority);
+};
+
+#endif // CALENDAR_CLIENT_H
@@ -0,0 +1,227 @@
+#include "CalendarMetrics.h"
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace {
+    // Counters of one thread. Only the owning thread writes them, so plain
+    // relaxed load/store pairs are enough and no update ever takes a lock.
+    struct OperationCounters {
+        std::atomic<std::uint64_t> calls{ 0 };
+        std::atomic<std::uint64_t> scanned{ 0 };
+        std::atomic<std::uint64_t> returned{ 0 };
+        std::atomic<std::uint64_t> totalNanoseconds{ 0 };
+        std::atomic<std::uint64_t> latency[CalendarMetrics::LATENCY_BUCKETS] = {};
+    };
+
+    struct ThreadCounters {
+        OperationCounters operations[CalendarMetrics::OPERATIONS];
+    };
+
+    void bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    void accumulate(CalendarMetrics::Snapshot& totals, const ThreadCounters& counters) {
+        for (int op = 0; op < CalendarMetrics::OPERATIONS; ++op) {
+            const OperationCounters& source = counters.operations[op];
+            CalendarMetrics::OperationTotals& target = totals[op];
+            target.calls += source.calls.load(std::memory_order_relaxed);
+            target.scanned += source.scanned.load(std::memory_order_relaxed);
+            target.returned += source.returned.load(std::memory_order_relaxed);
+            target.totalNanoseconds += source.totalNanoseconds.load(std::memory_order_relaxed);
+            for (int bucket = 0; bucket < CalendarMetrics::LATENCY_BUCKETS; ++bucket) {
+                target.latency[bucket] += source.latency[bucket].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void clear(ThreadCounters& counters) {
+        for (auto& operation : counters.operations) {
+            operation.calls.store(0, std::memory_order_relaxed);
+            operation.scanned.store(0, std::memory_order_relaxed);
+            operation.returned.store(0, std::memory_order_relaxed);
+            operation.totalNanoseconds.store(0, std::memory_order_relaxed);
+            for (auto& bucket : operation.latency) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Live thread blocks plus the totals of threads that have exited
+    struct Registry {
+        std::mutex mutex;
+        std::vector<ThreadCounters*> threads;
+        CalendarMetrics::Snapshot retired{};
+    };
+
+    Registry& registry() {
+        static Registry* instance = new Registry();
+        return *instance;
+    }
+
+    struct ThreadRegistration {
+        ThreadCounters counters;
+
+        ThreadRegistration() {
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.threads.push_back(&counters);
+        }
+
+        ~ThreadRegistration() {
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            accumulate(shared.retired, counters);
+            for (auto it = shared.threads.begin(); it != shared.threads.end(); ++it) {
+                if (*it == &counters) {
+                    shared.threads.erase(it);
+                    break;
+                }
+            }
+        }
+    };
+
+    ThreadCounters& localCounters() {
+        thread_local ThreadRegistration registration;
+        return registration.counters;
+    }
+
+    int latencyBucket(std::uint64_t nanoseconds) {
+        int bucket = 0;
+        while (nanoseconds > 0 && bucket < CalendarMetrics::LATENCY_BUCKETS - 1) {
+            nanoseconds >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+}
+
+std::uint64_t CalendarMetrics::OperationTotals::percentile(double quantile) const {
+    if (calls == 0) {
+        return 0;
+    }
+
+    std::uint64_t target = static_cast<std::uint64_t>(quantile * static_cast<double>(calls));
+    std::uint64_t seen = 0;
+    for (int bucket = 0; bucket < LATENCY_BUCKETS; ++bucket) {
+        seen += latency[bucket];
+        if (seen > target || seen == calls) {
+            return bucket == 0 ? 0 : (std::uint64_t(1) << bucket) - 1;
+        }
+    }
+    return (std::uint64_t(1) << (LATENCY_BUCKETS - 1)) - 1;
+}
+
+void CalendarMetrics::record(CalendarOperation operation, std::uint64_t nanoseconds,
+    std::uint64_t scanned, std::uint64_t returned) {
+    OperationCounters& counters = localCounters().operations[static_cast<int>(operation)];
+    bump(counters.calls, 1);
+    bump(counters.scanned, scanned);
+    bump(counters.returned, returned);
+    bump(counters.totalNanoseconds, nanoseconds);
+    bump(counters.latency[latencyBucket(nanoseconds)], 1);
+}
+
+CalendarMetrics::Snapshot CalendarMetrics::snapshot() {
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+
+    Snapshot totals = shared.retired;
+    for (const ThreadCounters* counters : shared.threads) {
+        accumulate(totals, *counters);
+    }
+    return totals;
+}
+
+void CalendarMetrics::reset() {
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+
+    shared.retired = Snapshot{};
+    for (ThreadCounters* counters : shared.threads) {
+        clear(*counters);
+    }
+}
+
+const char* CalendarMetrics::operationName(CalendarOperation operation) {
+    switch (operation) {
+    case CalendarOperation::ADD_EVENT: return "addEvent";
+    case CalendarOperation::REMOVE_EVENT: return "removeEvent";
+    case CalendarOperation::GET_EVENTS_FOR_DAY: return "getEventsForDay";
+    case CalendarOperation::GET_EVENTS_FOR_MONTH: return "getEventsForMonth";
+    case CalendarOperation::GET_EVENTS_FOR_WEEK: return "getEventsForWeek";
+    case CalendarOperation::GET_EVENTS_IN_DATE_RANGE: return "getEventsInDateRange";
+    case CalendarOperation::GET_EVENTS_BY_TYPE: return "getEventsByType";
+    case CalendarOperation::GET_EVENTS_BY_PRIORITY: return "getEventsByPriority";
+    case CalendarOperation::GET_UPCOMING_EVENTS: return "getUpcomingEvents";
+    case CalendarOperation::GET_TOP_PRIORITY_EVENTS: return "getTopPriorityEvents";
+    case CalendarOperation::COUNT_EVENTS: return "countEvents";
+    case CalendarOperation::SEARCH_EVENTS: return "searchEvents";
+    case CalendarOperation::COMPLETE_TITLE: return "completeTitle";
+    case CalendarOperation::RENDER_WEEK: return "renderWeek";
+    case CalendarOperation::RENDER_MONTH: return "renderMonth";
+    case CalendarOperation::RENDER_YEAR: return "renderYear";
+    case CalendarOperation::RENDER_YEARS: return "renderYears";
+    case CalendarOperation::ARCHIVE_EVENTS: return "archiveEvents";
+    default: return "unknown";
+    }
+}
+
+std::string CalendarMetrics::toText() {
+    Snapshot totals = snapshot();
+    std::ostringstream oss;
+
+    oss << std::left << std::setw(22) << "operation" << std::right
+        << std::setw(10) << "calls" << std::setw(12) << "scanned" << std::setw(12) << "returned"
+        << std::setw(10) << "avg ns" << std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns" << "\n";
+
+    for (int op = 0; op < OPERATIONS; ++op) {
+        const OperationTotals& stats = totals[op];
+        if (stats.calls == 0) {
+            continue;
+        }
+
+        oss << std::left << std::setw(22) << operationName(static_cast<CalendarOperation>(op)) << std::right
+            << std::setw(10) << stats.calls << std::setw(12) << stats.scanned << std::setw(12) << stats.returned
+            << std::setw(10) << stats.totalNanoseconds / stats.calls
+            << std::setw(10) << stats.percentile(0.5) << std::setw(10) << stats.percentile(0.99) << "\n";
+    }
+
+    return oss.str();
+}
+
+std::string CalendarMetrics::toJson() {
+    Snapshot totals = snapshot();
+    std::ostringstream oss;
+
+    oss << "{\"operations\":{";
+    bool first = true;
+    for (int op = 0; op < OPERATIONS; ++op) {
+        const OperationTotals& stats = totals[op];
+
+        if (!first) {
+            oss << ",";
+        }
+        first = false;
+
+        oss << "\"" << operationName(static_cast<CalendarOperation>(op)) << "\":{"
+            << "\"calls\":" << stats.calls
+            << ",\"scanned\":" << stats.scanned
+            << ",\"returned\":" << stats.returned
+            << ",\"totalNs\":" << stats.totalNanoseconds
+            << ",\"p50Ns\":" << stats.percentile(0.5)
+            << ",\"p90Ns\":" << stats.percentile(0.9)
+            << ",\"p99Ns\":" << stats.percentile(0.99)
+            << ",\"latencyLog2Ns\":[";
+        for (int bucket = 0; bucket < LATENCY_BUCKETS; ++bucket) {
+            oss << (bucket > 0 ? "," : "") << stats.latency[bucket];
+        }
+        oss << "]}";
+    }
+    oss << "}}";
+
+    return oss.str();
+}
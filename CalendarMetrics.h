@@ -0,0 +1,98 @@
+#ifndef CALENDAR_METRICS_H
+#define CALENDAR_METRICS_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Build with CALENDAR_METRICS_ENABLED=0 to compile all instrumentation out
+#ifndef CALENDAR_METRICS_ENABLED
+#define CALENDAR_METRICS_ENABLED 1
+#endif
+
+enum class CalendarOperation {
+    ADD_EVENT,
+    REMOVE_EVENT,
+    GET_EVENTS_FOR_DAY,
+    GET_EVENTS_FOR_MONTH,
+    GET_EVENTS_FOR_WEEK,
+    GET_EVENTS_IN_DATE_RANGE,
+    GET_EVENTS_BY_TYPE,
+    GET_EVENTS_BY_PRIORITY,
+    GET_UPCOMING_EVENTS,
+    GET_TOP_PRIORITY_EVENTS,
+    COUNT_EVENTS,
+    SEARCH_EVENTS,
+    COMPLETE_TITLE,
+    RENDER_WEEK,
+    RENDER_MONTH,
+    RENDER_YEAR,
+    RENDER_YEARS,
+    ARCHIVE_EVENTS,
+    OPERATION_COUNT
+};
+
+class CalendarMetrics {
+public:
+    // Latency buckets are powers of two in nanoseconds: bucket i holds [2^(i-1), 2^i)
+    static constexpr int LATENCY_BUCKETS = 40;
+    static constexpr int OPERATIONS = static_cast<int>(CalendarOperation::OPERATION_COUNT);
+
+    struct OperationTotals {
+        std::uint64_t calls = 0;
+        std::uint64_t scanned = 0;
+        std::uint64_t returned = 0;
+        std::uint64_t totalNanoseconds = 0;
+        std::array<std::uint64_t, LATENCY_BUCKETS> latency{};
+
+        // Upper bound of the bucket holding the given quantile, in nanoseconds
+        std::uint64_t percentile(double quantile) const;
+    };
+
+    using Snapshot = std::array<OperationTotals, OPERATIONS>;
+
+    static void record(CalendarOperation operation, std::uint64_t nanoseconds,
+        std::uint64_t scanned, std::uint64_t returned);
+
+    static Snapshot snapshot();
+    static void reset();
+    static std::string toText();
+    static std::string toJson();
+    static const char* operationName(CalendarOperation operation);
+};
+
+class MetricsScope {
+private:
+    CalendarOperation operation;
+    std::chrono::steady_clock::time_point start;
+    std::uint64_t scannedCount = 0;
+    std::uint64_t returnedCount = 0;
+
+public:
+    explicit MetricsScope(CalendarOperation operation)
+        : operation(operation), start(std::chrono::steady_clock::now()) {}
+
+    ~MetricsScope() {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        CalendarMetrics::record(operation, static_cast<std::uint64_t>(elapsed.count()), scannedCount, returnedCount);
+    }
+
+    MetricsScope(const MetricsScope&) = delete;
+    MetricsScope& operator=(const MetricsScope&) = delete;
+
+    void scanned(std::uint64_t count) { scannedCount += count; }
+    void returned(std::uint64_t count) { returnedCount += count; }
+};
+
+#if CALENDAR_METRICS_ENABLED
+#define CALENDAR_METRICS_SCOPE(operation) MetricsScope calendarMetricsScope(operation)
+#define CALENDAR_METRICS_SCANNED(count) calendarMetricsScope.scanned(count)
+#define CALENDAR_METRICS_RETURNED(count) calendarMetricsScope.returned(count)
+#else
+#define CALENDAR_METRICS_SCOPE(operation) ((void)0)
+#define CALENDAR_METRICS_SCANNED(count) ((void)0)
+#define CALENDAR_METRICS_RETURNED(count) ((void)0)
+#endif
+
+#endif // CALENDAR_METRICS_H
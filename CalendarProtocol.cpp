@@ -0,0 +1,126 @@
+#include "CalendarProtocol.h"
+#include <stdexcept>
+
+namespace {
+
+constexpr int NO_TIME = 24 * 60 * 60;
+// Day serials of 1 January 1 and 31 December 9999
+constexpr std::int32_t MIN_DAY_SERIAL = 307;
+constexpr std::int32_t MAX_DAY_SERIAL = 3652365;
+
+}
+
+void ProtocolWriter::beginFrame(std::uint8_t code, std::uint32_t id) {
+    frameStart = out.size();
+    u32(0);
+    u8(code);
+    u32(id);
+}
+
+void ProtocolWriter::endFrame() {
+    u32At(frameStart, static_cast<std::uint32_t>(out.size() - frameStart - 4));
+}
+
+void ProtocolWriter::u32At(size_t offset, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[offset + i] = static_cast<char>(value >> (8 * i));
+    }
+}
+
+void ProtocolWriter::u32(std::uint32_t value) {
+    char bytes[4] = {
+        static_cast<char>(value), static_cast<char>(value >> 8),
+        static_cast<char>(value >> 16), static_cast<char>(value >> 24)
+    };
+    out.append(bytes, 4);
+}
+
+void ProtocolWriter::text(std::string_view value) {
+    u32(static_cast<std::uint32_t>(value.size()));
+    out.append(value.data(), value.size());
+}
+
+void ProtocolWriter::event(const Event& value) {
+    EventKey key = value.sortKey();
+    i32(key.first);
+    i32(key.second);
+    u8(static_cast<std::uint8_t>(value.getType()));
+    u8(static_cast<std::uint8_t>(value.getPriority()));
+    text(value.getTitle());
+    text(value.getDescription());
+}
+
+const char* ProtocolReader::take(size_t count) {
+    if (count > input.size() - position) {
+        throw std::runtime_error("Truncated message");
+    }
+    const char* data = input.data() + position;
+    position += count;
+    return data;
+}
+
+std::uint8_t ProtocolReader::u8() {
+    return static_cast<std::uint8_t>(*take(1));
+}
+
+std::uint32_t ProtocolReader::u32() {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(take(4));
+    return static_cast<std::uint32_t>(bytes[0]) | static_cast<std::uint32_t>(bytes[1]) << 8 |
+        static_cast<std::uint32_t>(bytes[2]) << 16 | static_cast<std::uint32_t>(bytes[3]) << 24;
+}
+
+std::string_view ProtocolReader::text() {
+    std::uint32_t length = u32();
+    return std::string_view(take(length), length);
+}
+
+Date ProtocolReader::date() {
+    std::int32_t serial = i32();
+    if (serial < MIN_DAY_SERIAL || serial > MAX_DAY_SERIAL) {
+        throw std::runtime_error("Date out of range");
+    }
+    return Date::fromSerial(serial);
+}
+
+Event ProtocolReader::event() {
+    Date day = date();
+    std::int32_t seconds = i32();
+    std::uint8_t type = u8();
+    std::uint8_t priority = u8();
+    std::string_view title = text();
+    std::string_view description = text();
+
+    if (seconds < 0 || seconds > NO_TIME) {
+        throw std::runtime_error("Invalid event time");
+    }
+    if (type > static_cast<std::uint8_t>(EventType::OTHER) || priority > static_cast<std::uint8_t>(EventPriority::URGENT)) {
+        throw std::runtime_error("Invalid event type or priority");
+    }
+
+    if (seconds == NO_TIME) {
+        return Event(day, std::string(title), static_cast<EventType>(type), static_cast<EventPriority>(priority),
+            std::string(description));
+    }
+    return Event(day, Time(seconds / 3600, seconds / 60 % 60, seconds % 60), std::string(title),
+        static_cast<EventType>(type), static_cast<EventPriority>(priority), std::string(description));
+}
+
+bool nextFrame(std::string_view buffer, size_t& offset, Frame& frame) {
+    if (buffer.size() - offset < 4) {
+        return false;
+    }
+    ProtocolReader header(buffer.substr(offset, FRAME_HEADER_SIZE));
+    std::uint32_t length = header.u32();
+    if (length < FRAME_HEADER_SIZE - 4 || length > MAX_FRAME_SIZE) {
+        throw std::runtime_error("Invalid frame length");
+    }
+    if (buffer.size() - offset - 4 < length) {
+        return false;
+    }
+
+    frame.code = header.u8();
+    frame.id = header.u32();
+    frame.body = buffer.substr(offset + FRAME_HEADER_SIZE, length - (FRAME_HEADER_SIZE - 4));
+    offset += 4 + length;
+    return true;
+}
@@ -0,0 +1,90 @@
+#ifndef CALENDAR_PROTOCOL_H
+#define CALENDAR_PROTOCOL_H
+
+#include "Event.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Binary protocol of CalendarServer. Every message is a frame:
+//   u32 length of the rest of the frame, u8 code, u32 request id, body
+// Integers are little-endian. Requests carry a RequestType code; responses echo the
+// request id and carry a ResponseStatus code. Clients may pipeline any number of
+// requests; responses come back in request order.
+enum class RequestType : std::uint8_t {
+    ADD_EVENT = 1,                  // body: event
+    REMOVE_EVENT = 2,               // body: i32 day serial, i32 seconds (86400 = untimed)
+    GET_EVENTS_IN_DATE_RANGE = 3,   // body: i32 first day serial, i32 last day serial
+    GET_EVENTS_BY_TYPE = 4,         // body: u8 type
+    GET_EVENTS_BY_PRIORITY = 5      // body: u8 priority
+};
+
+// OK bodies: u32 count, then that many events for queries (count only for add and remove);
+// ERROR bodies: u32 length + message. Query results come in date and time order; range
+// queries include archived events and recurring occurrences. A query whose events would not
+// fit in MAX_FRAME_SIZE gets an ERROR instead.
+enum class ResponseStatus : std::uint8_t {
+    OK = 0,
+    ERROR = 1
+};
+
+struct Frame {
+    std::uint8_t code = 0;
+    std::uint32_t id = 0;
+    std::string_view body;
+};
+
+// Appends little-endian fields to a buffer
+class ProtocolWriter {
+private:
+    std::string& out;
+    size_t frameStart = 0;
+
+public:
+    explicit ProtocolWriter(std::string& out) : out(out) {}
+
+    // Frames are written in place; the length is patched in by endFrame()
+    void beginFrame(std::uint8_t code, std::uint32_t id);
+    void endFrame();
+
+    void u8(std::uint8_t value) { out.push_back(static_cast<char>(value)); }
+    void u32(std::uint32_t value);
+    // Overwrites four bytes already written at `offset`
+    void u32At(size_t offset, std::uint32_t value);
+    void i32(std::int32_t value) { u32(static_cast<std::uint32_t>(value)); }
+    void text(std::string_view value);
+    // i32 day serial, i32 seconds, u8 type, u8 priority, title, description
+    void event(const Event& value);
+};
+
+// Reads little-endian fields; throws std::runtime_error past the end of the input
+class ProtocolReader {
+private:
+    std::string_view input;
+    size_t position = 0;
+
+    const char* take(size_t count);
+
+public:
+    explicit ProtocolReader(std::string_view input) : input(input) {}
+
+    std::uint8_t u8();
+    std::uint32_t u32();
+    std::int32_t i32() { return static_cast<std::int32_t>(u32()); }
+    std::string_view text();
+    // i32 day serial; throws std::runtime_error outside years 1 to 9999
+    Date date();
+    Event event();
+
+    bool atEnd() const { return position == input.size(); }
+};
+
+// Frames larger than this are rejected rather than buffered, in either direction
+constexpr size_t MAX_FRAME_SIZE = 16 * 1024 * 1024;
+constexpr size_t FRAME_HEADER_SIZE = 4 + 1 + 4;
+
+// Takes the next complete frame starting at `offset` and advances past it; returns false
+// if the buffer ends inside the frame. Throws std::runtime_error on an oversized frame.
+bool nextFrame(std::string_view buffer, size_t& offset, Frame& frame);
+
+#endif // CALENDAR_PROTOCOL_H
@@ -0,0 +1,359 @@
+#include "CalendarServer.h"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::int32_t NO_TIME = 24 * 60 * 60;
+
+std::runtime_error systemError(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+void expectEnd(const ProtocolReader& reader) {
+    if (!reader.atEnd()) {
+        throw std::runtime_error("Unexpected data after request");
+    }
+}
+
+// Writes the matching events behind a u32 count. Clients reject frames over MAX_FRAME_SIZE,
+// so the walk gives up as soon as the frame outgrows one rather than collecting the rest.
+template <typename Cursor, typename Predicate>
+void writeEvents(Cursor cursor, Predicate matches, ProtocolWriter& writer, const std::string& out, size_t frameStart) {
+    size_t countOffset = out.size();
+    writer.u32(0);
+    std::uint32_t count = 0;
+    while (cursor.hasNext()) {
+        std::shared_ptr<const Event> event = cursor.next();
+        if (!matches(*event)) {
+            continue;
+        }
+        writer.event(*event);
+        ++count;
+        if (out.size() - frameStart - 4 > MAX_FRAME_SIZE) {
+            throw std::runtime_error("Response too large; narrow the query");
+        }
+    }
+    writer.u32At(countOffset, count);
+}
+
+}
+
+CalendarServer::CalendarServer(Calendar& calendar, const std::string& socketPath)
+    : calendar(calendar), path(socketPath) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Invalid socket path: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    struct stat existing;
+    if (::stat(path.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) {
+        ::unlink(path.c_str());
+    }
+
+    listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener < 0) {
+        throw systemError("Unable to create socket");
+    }
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(listener, SOMAXCONN) < 0) {
+        std::runtime_error error = systemError("Unable to listen on " + path);
+        close();
+        throw error;
+    }
+
+    poller = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeup = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (poller < 0 || wakeup < 0) {
+        std::runtime_error error = systemError("Unable to create event loop");
+        close();
+        ::unlink(path.c_str());
+        throw error;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listener;
+    ::epoll_ctl(poller, EPOLL_CTL_ADD, listener, &event);
+    event.data.fd = wakeup;
+    ::epoll_ctl(poller, EPOLL_CTL_ADD, wakeup, &event);
+}
+
+CalendarServer::~CalendarServer() {
+    close();
+    ::unlink(path.c_str());
+}
+
+void CalendarServer::close() {
+    for (auto& connection : connections) {
+        ::close(connection.first);
+    }
+    connections.clear();
+    for (int* fd : { &listener, &poller, &wakeup }) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+void CalendarServer::stop() {
+    running.store(false);
+    std::uint64_t one = 1;
+    ssize_t written = ::write(wakeup, &one, sizeof(one));
+    (void)written;
+}
+
+void CalendarServer::run() {
+    epoll_event ready[64];
+    while (running.load()) {
+        int count = ::epoll_wait(poller, ready, 64, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw systemError("Event loop failed");
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int fd = ready[i].data.fd;
+            if (fd == listener) {
+                acceptClients();
+                continue;
+            }
+            if (fd == wakeup) {
+                std::uint64_t value;
+                ssize_t received = ::read(wakeup, &value, sizeof(value));
+                (void)received;
+                continue;
+            }
+
+            auto it = connections.find(fd);
+            if (it == connections.end()) {
+                continue;
+            }
+            Connection& connection = it->second;
+            bool open = true;
+            if (ready[i].events & EPOLLOUT) {
+                // Draining the output may let a paused client be read again
+                open = flush(fd, connection) && process(connection) && flush(fd, connection);
+            }
+            if (open && (ready[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+                open = readFrom(fd, connection);
+            }
+            // After a half-close, answer what is left as output drains and close once nothing more comes of it
+            while (open && connection.inputClosed && connection.output.empty()) {
+                open = process(connection) && !connection.output.empty() && flush(fd, connection);
+            }
+            if (open) {
+                watch(fd, connection);
+            }
+            else {
+                disconnect(fd);
+            }
+        }
+    }
+}
+
+void CalendarServer::acceptClients() {
+    for (;;) {
+        int fd = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        Connection& connection = connections[fd];
+        connection.events = EPOLLIN;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        ::epoll_ctl(poller, EPOLL_CTL_ADD, fd, &event);
+        ++stats.connections;
+    }
+}
+
+bool CalendarServer::readFrom(int fd, Connection& connection) {
+    for (int reads = 0; reads < READS_PER_WAKEUP && !connection.inputClosed && connection.output.size() - connection.outputOffset < OUTPUT_LIMIT; ++reads) {
+        size_t used = connection.input.size();
+        connection.input.resize(used + READ_CHUNK);
+        ssize_t received = ::recv(fd, &connection.input[used], READ_CHUNK, 0);
+        connection.input.resize(used + (received > 0 ? static_cast<size_t>(received) : 0));
+
+        if (received == 0) {
+            // Half-closed clients still get the answers to what they sent
+            connection.inputClosed = true;
+            break;
+        }
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return false;
+        }
+        if (!process(connection)) {
+            return false;
+        }
+    }
+    return flush(fd, connection);
+}
+
+// Answers every complete frame in the input, stopping early once enough output is pending
+bool CalendarServer::process(Connection& connection) {
+    Frame frame;
+    try {
+        while (connection.output.size() - connection.outputOffset < OUTPUT_LIMIT &&
+            nextFrame(connection.input, connection.inputOffset, frame)) {
+            handle(frame, connection.output);
+        }
+    }
+    catch (const std::runtime_error&) {
+        // Framing is lost; nothing after this point can be trusted
+        return false;
+    }
+
+    if (connection.inputOffset == connection.input.size()) {
+        connection.input.clear();
+        connection.inputOffset = 0;
+    }
+    else if (connection.inputOffset > connection.input.size() / 2) {
+        connection.input.erase(0, connection.inputOffset);
+        connection.inputOffset = 0;
+    }
+    return true;
+}
+
+void CalendarServer::handle(const Frame& frame, std::string& out) {
+    ++stats.requests;
+    size_t start = out.size();
+    ProtocolWriter writer(out);
+    writer.beginFrame(static_cast<std::uint8_t>(ResponseStatus::OK), frame.id);
+
+    try {
+        // The whole body is decoded and checked before the calendar is touched
+        ProtocolReader reader(frame.body);
+
+        switch (static_cast<RequestType>(frame.code)) {
+        case RequestType::ADD_EVENT: {
+            Event event = reader.event();
+            expectEnd(reader);
+            calendar.addEvent(std::move(event));
+            writer.u32(1);
+            writer.endFrame();
+            return;
+        }
+        case RequestType::REMOVE_EVENT: {
+            Date date = reader.date();
+            std::int32_t seconds = reader.i32();
+            expectEnd(reader);
+            if (seconds < 0 || seconds > NO_TIME) {
+                throw std::runtime_error("Invalid event time");
+            }
+            // Removal matches on date and time only
+            Event key = seconds == NO_TIME ? Event(date, std::string())
+                : Event(date, Time(seconds / 3600, seconds / 60 % 60, seconds % 60), std::string());
+            size_t before = calendar.countEvents(date, date);
+            calendar.removeEvent(key);
+            writer.u32(static_cast<std::uint32_t>(before - calendar.countEvents(date, date)));
+            writer.endFrame();
+            return;
+        }
+        case RequestType::GET_EVENTS_IN_DATE_RANGE: {
+            Date first = reader.date();
+            Date last = reader.date();
+            expectEnd(reader);
+            writeEvents(calendar.getMergedCursor(first, last), [](const Event&) { return true; }, writer, out, start);
+            break;
+        }
+        case RequestType::GET_EVENTS_BY_TYPE: {
+            std::uint8_t type = reader.u8();
+            expectEnd(reader);
+            if (type > static_cast<std::uint8_t>(EventType::OTHER)) {
+                throw std::runtime_error("Invalid event type");
+            }
+            writeEvents(calendar.getAllEvents(), [type](const Event& event) {
+                return event.getType() == static_cast<EventType>(type);
+                }, writer, out, start);
+            break;
+        }
+        case RequestType::GET_EVENTS_BY_PRIORITY: {
+            std::uint8_t priority = reader.u8();
+            expectEnd(reader);
+            if (priority > static_cast<std::uint8_t>(EventPriority::URGENT)) {
+                throw std::runtime_error("Invalid event priority");
+            }
+            writeEvents(calendar.getAllEvents(), [priority](const Event& event) {
+                return event.getPriority() == static_cast<EventPriority>(priority);
+                }, writer, out, start);
+            break;
+        }
+        default:
+            throw std::runtime_error("Unknown request type");
+        }
+    }
+    catch (const std::exception& error) {
+        ++stats.errors;
+        out.resize(start);
+        writer.beginFrame(static_cast<std::uint8_t>(ResponseStatus::ERROR), frame.id);
+        writer.text(error.what());
+    }
+    writer.endFrame();
+}
+
+bool CalendarServer::flush(int fd, Connection& connection) {
+    while (connection.outputOffset < connection.output.size()) {
+        ssize_t sent = ::send(fd, connection.output.data() + connection.outputOffset,
+            connection.output.size() - connection.outputOffset, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        connection.outputOffset += static_cast<size_t>(sent);
+        ++stats.writes;
+    }
+    connection.output.clear();
+    connection.outputOffset = 0;
+    return true;
+}
+
+// Wants output space while responses are pending, and input while there is room for more
+void CalendarServer::watch(int fd, Connection& connection) {
+    size_t pending = connection.output.size() - connection.outputOffset;
+    std::uint32_t events = 0;
+    if (pending < OUTPUT_LIMIT && !connection.inputClosed) {
+        events |= EPOLLIN;
+    }
+    if (pending > 0) {
+        events |= EPOLLOUT;
+    }
+    if (events != connection.events) {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd;
+        ::epoll_ctl(poller, EPOLL_CTL_MOD, fd, &event);
+        connection.events = events;
+    }
+}
+
+void CalendarServer::disconnect(int fd) {
+    ::epoll_ctl(poller, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections.erase(fd);
+}
+
+#endif // __linux__
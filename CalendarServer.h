@@ -0,0 +1,76 @@
+#ifndef CALENDAR_SERVER_H
+#define CALENDAR_SERVER_H
+
+#include "Calendar.h"
+#include "CalendarProtocol.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// Hosts one Calendar behind a Unix domain socket (Linux: epoll + eventfd).
+// A single thread runs the event loop, so the calendar needs no locking. Each read
+// is parsed into as many complete frames as it holds, and the responses to all of
+// them go out in one write.
+class CalendarServer {
+public:
+    struct Stats {
+        std::uint64_t connections = 0;
+        std::uint64_t requests = 0;
+        std::uint64_t errors = 0;
+        std::uint64_t writes = 0;
+    };
+
+private:
+    static constexpr size_t READ_CHUNK = 64 * 1024;
+    static constexpr int READS_PER_WAKEUP = 16;
+    // Reading from a client pauses while this much of its output is unsent
+    static constexpr size_t OUTPUT_LIMIT = 8 * 1024 * 1024;
+
+    struct Connection {
+        std::string input;
+        size_t inputOffset = 0;
+        std::string output;
+        size_t outputOffset = 0;
+        std::uint32_t events = 0;   // epoll mask currently registered
+        bool inputClosed = false;   // the client shut down its side; closed once output drains
+    };
+
+    Calendar& calendar;
+    std::string path;
+    int listener = -1;
+    int poller = -1;
+    int wakeup = -1;
+    std::atomic<bool> running{ true };
+    std::unordered_map<int, Connection> connections;
+    Stats stats;
+
+    void acceptClients();
+    bool readFrom(int fd, Connection& connection);
+    bool process(Connection& connection);
+    void handle(const Frame& frame, std::string& out);
+    bool flush(int fd, Connection& connection);
+    void watch(int fd, Connection& connection);
+    void disconnect(int fd);
+    void close();
+
+public:
+    // Binds and listens; a stale socket file at `socketPath` is replaced.
+    // Throws std::runtime_error if the socket cannot be set up.
+    CalendarServer(Calendar& calendar, const std::string& socketPath);
+    ~CalendarServer();
+
+    CalendarServer(const CalendarServer&) = delete;
+    CalendarServer& operator=(const CalendarServer&) = delete;
+
+    // Serves clients until stop() is called
+    void run();
+    // Safe from other threads and from signal handlers
+    void stop();
+
+    const std::string& getPath() const { return path; }
+    // Only meaningful while run() is not executing
+    const Stats& getStats() const { return stats; }
+};
+
+#endif // CALENDAR_SERVER_H
@@ -0,0 +1,59 @@
+#include "CalendarView.h"
+#include <algorithm>
+
+CalendarView::CalendarView(const std::vector<const Calendar*>& calendars) : calendars(calendars) {}
+
+void CalendarView::addCalendar(const Calendar& calendar) {
+    calendars.push_back(&calendar);
+}
+
+bool CalendarView::Cursor::later(const Source& a, const Source& b) {
+    if (a.cursor.peekKey() != b.cursor.peekKey()) {
+        return a.cursor.peekKey() > b.cursor.peekKey();
+    }
+    return a.calendar > b.calendar;
+}
+
+CalendarView::Cursor::Cursor(std::vector<Source> sources) : heap(std::move(sources)) {
+    heap.erase(std::remove_if(heap.begin(), heap.end(),
+        [](const Source& source) { return !source.cursor.hasNext(); }),
+        heap.end());
+    std::make_heap(heap.begin(), heap.end(), later);
+}
+
+std::shared_ptr<const Event> CalendarView::Cursor::next() {
+    std::pop_heap(heap.begin(), heap.end(), later);
+    Source& top = heap.back();
+    std::shared_ptr<const Event> event = top.cursor.next();
+
+    if (top.cursor.hasNext()) {
+        std::push_heap(heap.begin(), heap.end(), later);
+    }
+    else {
+        heap.pop_back();
+    }
+
+    return event;
+}
+
+CalendarView::Cursor CalendarView::getEvents(const Date& start, const Date& end) const {
+    std::vector<Cursor::Source> sources;
+    sources.reserve(calendars.size());
+
+    for (size_t i = 0; i < calendars.size(); ++i) {
+        sources.push_back({ i, calendars[i]->getMergedCursor(start, end) });
+    }
+
+    return Cursor(std::move(sources));
+}
+
+std::vector<std::shared_ptr<const Event>> CalendarView::getPage(const Date& start, const Date& end, size_t count) const {
+    std::vector<std::shared_ptr<const Event>> result;
+    Cursor cursor = getEvents(start, end);
+
+    while (result.size() < count && cursor.hasNext()) {
+        result.push_back(cursor.next());
+    }
+
+    return result;
+}
@@ -0,0 +1,49 @@
+#ifndef CALENDAR_VIEW_H
+#define CALENDAR_VIEW_H
+
+#include "Calendar.h"
+#include <vector>
+#include <memory>
+
+// Read-only agenda over several calendars, merged in date and time order. Archived events
+// and recurring occurrences are included, as in each calendar's merged cursor.
+// The calendars must outlive the view and stay unmodified while a cursor is in use.
+class CalendarView {
+private:
+    std::vector<const Calendar*> calendars;
+
+public:
+    class Cursor {
+    private:
+        struct Source {
+            size_t calendar;
+            MergedEventCursor cursor;
+        };
+
+        std::vector<Source> heap;
+
+        static bool later(const Source& a, const Source& b);
+
+        Cursor(std::vector<Source> sources);
+
+    public:
+
+        bool hasNext() const { return !heap.empty(); }
+        const std::shared_ptr<const Event>& peek() const { return heap.front().cursor.peek(); }
+        size_t peekCalendar() const { return heap.front().calendar; }
+        std::shared_ptr<const Event> next();
+
+        friend class CalendarView;
+    };
+
+    CalendarView() = default;
+    CalendarView(const std::vector<const Calendar*>& calendars);
+
+    void addCalendar(const Calendar& calendar);
+    size_t calendarCount() const { return calendars.size(); }
+
+    Cursor getEvents(const Date& start, const Date& end) const;
+    std::vector<std::shared_ptr<const Event>> getPage(const Date& start, const Date& end, size_t count) const;
+};
+
+#endif // CALENDAR_VIEW_H
@@ -0,0 +1,129 @@
+#include "ColumnarEventStore.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EVENT_COLUMNS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+inline unsigned lowestBit(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+template <typename T>
+void eraseRows(std::vector<T>& column, const std::vector<std::uint32_t>& rows) {
+    size_t write = rows.front();
+    size_t next = 0;
+    for (size_t read = rows.front(); read < column.size(); ++read) {
+        if (next < rows.size() && rows[next] == read) {
+            ++next;
+            continue;
+        }
+        column[write++] = column[read];
+    }
+    column.resize(write);
+}
+
+}
+
+void EventColumns::push(const Event& event) {
+    days.push_back(event.getDate().toSerial());
+    types.push_back(static_cast<std::uint8_t>(event.getType()));
+    priorities.push_back(static_cast<std::uint8_t>(event.getPriority()));
+}
+
+void EventColumns::assign(const std::vector<std::shared_ptr<const Event>>& events) {
+    clear();
+    reserve(events.size());
+    for (const auto& event : events) {
+        push(*event);
+    }
+}
+
+void EventColumns::erase(const std::vector<std::uint32_t>& rows) {
+    if (rows.empty()) {
+        return;
+    }
+    eraseRows(days, rows);
+    eraseRows(types, rows);
+    eraseRows(priorities, rows);
+}
+
+void EventColumns::reserve(size_t count) {
+    days.reserve(count);
+    types.reserve(count);
+    priorities.reserve(count);
+}
+
+void EventColumns::clear() {
+    days.clear();
+    types.clear();
+    priorities.clear();
+}
+
+std::vector<std::uint32_t> EventColumns::select(const ColumnFilter& filter) const {
+    std::vector<std::uint32_t> rows;
+    if (filter.lastDay < filter.firstDay) {
+        return rows;
+    }
+
+    const size_t count = days.size();
+    const std::uint8_t type = static_cast<std::uint8_t>(filter.type.value_or(EventType::OTHER));
+    const std::uint8_t priority = static_cast<std::uint8_t>(filter.priority.value_or(EventPriority::LOW));
+    size_t row = 0;
+
+#ifdef EVENT_COLUMNS_SSE2
+    const __m128i firstDay = _mm_set1_epi32(filter.firstDay);
+    const __m128i lastDay = _mm_set1_epi32(filter.lastDay);
+    const __m128i typeValue = _mm_set1_epi8(static_cast<char>(type));
+    const __m128i priorityValue = _mm_set1_epi8(static_cast<char>(priority));
+    const bool anyDay = filter.firstDay == INT_MIN && filter.lastDay == INT_MAX;
+
+    for (; row + 16 <= count; row += 16) {
+        unsigned mask = 0xFFFF;
+
+        if (!anyDay) {
+            mask = 0;
+            for (int part = 0; part < 4; ++part) {
+                __m128i day = _mm_loadu_si128(reinterpret_cast<const __m128i*>(days.data() + row + 4 * part));
+                __m128i outside = _mm_or_si128(_mm_cmplt_epi32(day, firstDay), _mm_cmpgt_epi32(day, lastDay));
+                unsigned inside = ~static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(outside))) & 0xF;
+                mask |= inside << (4 * part);
+            }
+        }
+        if (filter.type && mask != 0) {
+            __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(types.data() + row));
+            mask &= static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(values, typeValue)));
+        }
+        if (filter.priority && mask != 0) {
+            __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(priorities.data() + row));
+            mask &= static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(values, priorityValue)));
+        }
+
+        while (mask != 0) {
+            rows.push_back(static_cast<std::uint32_t>(row + lowestBit(mask)));
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; row < count; ++row) {
+        if (days[row] >= filter.firstDay && days[row] <= filter.lastDay &&
+            (!filter.type || types[row] == type) && (!filter.priority || priorities[row] == priority)) {
+            rows.push_back(static_cast<std::uint32_t>(row));
+        }
+    }
+
+    return rows;
+}
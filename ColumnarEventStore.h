@@ -0,0 +1,42 @@
+#ifndef COLUMNAR_EVENT_STORE_H
+#define COLUMNAR_EVENT_STORE_H
+
+#include "Event.h"
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// Conditions of a column scan; unset fields match every row
+struct ColumnFilter {
+    int firstDay = INT_MIN;
+    int lastDay = INT_MAX;
+    std::optional<EventType> type;
+    std::optional<EventPriority> priority;
+};
+
+// Filter fields of events as packed parallel columns, scanned 16 rows at a time with SSE2
+// where available. Row i describes the i-th event pushed. Backs Calendar's columnar scans;
+// titles and descriptions stay in the events and are read only for the selected rows.
+class EventColumns {
+private:
+    std::vector<std::int32_t> days;
+    std::vector<std::uint8_t> types;
+    std::vector<std::uint8_t> priorities;
+
+public:
+    void push(const Event& event);
+    void assign(const std::vector<std::shared_ptr<const Event>>& events);
+    // Drops the given rows (ascending) and closes the gaps
+    void erase(const std::vector<std::uint32_t>& rows);
+    void reserve(size_t count);
+    void clear();
+
+    size_t size() const { return days.size(); }
+
+    // Matching rows in ascending order
+    std::vector<std::uint32_t> select(const ColumnFilter& filter) const;
+};
+
+#endif // COLUMNAR_EVENT_STORE_H
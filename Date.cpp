@@ -117,24 +117,61 @@ Date Date::operator-(int days) const {
     return result;
 }
 
-int Date::operator-(const Date& other) const {
-    auto dateToInt = [](const Date& d) {
-        int m = d.month;
-        int y = d.year;
+int Date::getIsoWeekday() const {
+    int weekday = (toSerial() + 1) % 7;
+    return (weekday < 0 ? weekday + 7 : weekday) + 1;
+}
 
-        if (m <= 2) {
-            m += 12;
-            y -= 1;
-        }
+// The ISO week-year is the year of the week's Thursday
+int Date::getIsoWeek() const {
+    int thursday = toSerial() - getIsoWeekday() + 4;
+    return (thursday - Date(1, 1, fromSerial(thursday).getYear()).toSerial()) / 7 + 1;
+}
 
-        int days = d.day;
-        days += (153 * m - 457) / 5; 
-        days += 365 * y + y / 4 - y / 100 + y / 400; 
+int Date::getIsoWeekYear() const {
+    return fromSerial(toSerial() - getIsoWeekday() + 4).getYear();
+}
 
-        return days;
-        };
+// Week 1 is the week containing 4 January
+Date Date::fromIsoWeek(int weekYear, int week, int weekday) {
+    Date january4(4, 1, weekYear);
+    int firstMonday = january4.toSerial() - january4.getIsoWeekday() + 1;
+    return fromSerial(firstMonday + (week - 1) * 7 + weekday - 1);
+}
 
-    return dateToInt(*this) - dateToInt(other);
+int Date::toSerial() const {
+    int m = month;
+    int y = year;
+
+    if (m <= 2) {
+        m += 12;
+        y -= 1;
+    }
+
+    int days = day;
+    days += (153 * m - 457) / 5;
+    days += 365 * y + y / 4 - y / 100 + y / 400;
+
+    return days;
+}
+
+Date Date::fromSerial(int serial) {
+    int z = serial - 1;
+    int era = (z >= 0 ? z : z - 146096) / 146097;
+    int doe = z - era * 146097;
+    int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int mp = (5 * doy + 2) / 153;
+
+    int d = doy - (153 * mp + 2) / 5 + 1;
+    int m = mp < 10 ? mp + 3 : mp - 9;
+    int y = yoe + era * 400 + (m <= 2 ? 1 : 0);
+
+    return Date(d, m, y);
+}
+
+int Date::operator-(const Date& other) const {
+    return toSerial() - other.toSerial();
 }
 
 Date& Date::operator+=(int days) {
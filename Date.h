@@ -29,6 +29,18 @@ public:
     bool setYear(int y);
 
     std::string getDayOfWeek() const;
+    // 1 = Monday ... 7 = Sunday
+    int getIsoWeekday() const;
+    // ISO-8601 week (1..53) and the year it belongs to, which differs from getYear()
+    // for a few days around New Year
+    int getIsoWeek() const;
+    int getIsoWeekYear() const;
+    // Day `weekday` (1 = Monday) of ISO week `week`; weeks past the end of the year roll over
+    static Date fromIsoWeek(int weekYear, int week, int weekday = 1);
+
+    // Consecutive day number, suitable as an index key
+    int toSerial() const;
+    static Date fromSerial(int serial);
 
     
     Date& operator++();   
@@ -0,0 +1,62 @@
+#include "EditHistory.h"
+
+size_t EditHistory::costOf(const Edit& edit) {
+    size_t cost = sizeof(Edit);
+    if (!edit.before.isMapped()) {
+        cost += edit.before.size();
+    }
+    if (!edit.after.isMapped()) {
+        cost += edit.after.size();
+    }
+    return cost;
+}
+
+void EditHistory::record(Edit edit) {
+    for (const Edit& dropped : undone) {
+        bytes -= costOf(dropped);
+    }
+    undone.clear();
+
+    if (!done.empty() && edit.kind == EditKind::REPLACE && done.back().index == edit.index &&
+        done.back().kind != EditKind::ERASE) {
+        Edit& previous = done.back();
+        bytes -= costOf(previous);
+        previous.after = std::move(edit.after);
+        bytes += costOf(previous);
+    }
+    else {
+        bytes += costOf(edit);
+        done.push_back(std::move(edit));
+    }
+    trim();
+}
+
+void EditHistory::trim() {
+    while (bytes > limit && !done.empty()) {
+        bytes -= costOf(done.front());
+        done.pop_front();
+    }
+}
+
+const Edit& EditHistory::takeUndo() {
+    undone.push_back(std::move(done.back()));
+    done.pop_back();
+    return undone.back();
+}
+
+const Edit& EditHistory::takeRedo() {
+    done.push_back(std::move(undone.back()));
+    undone.pop_back();
+    return done.back();
+}
+
+void EditHistory::clear() {
+    done.clear();
+    undone.clear();
+    bytes = 0;
+}
+
+void EditHistory::setLimit(size_t limitBytes) {
+    limit = limitBytes;
+    trim();
+}
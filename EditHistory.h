@@ -0,0 +1,60 @@
+#ifndef EDIT_HISTORY_H
+#define EDIT_HISTORY_H
+
+#include "Paragraph.h"
+#include <cstddef>
+#include <deque>
+
+enum class EditKind {
+    INSERT,
+    ERASE,
+    REPLACE
+};
+
+// One paragraph-level edit. Paragraph handles share their text with the document,
+// so recording an edit copies no text.
+struct Edit {
+    EditKind kind = EditKind::REPLACE;
+    size_t index = 0;
+    Paragraph before;   // ERASE and REPLACE
+    Paragraph after;    // INSERT and REPLACE
+};
+
+// Undo and redo stacks of edits within a memory budget; the oldest edits are
+// forgotten first once the budget is exceeded
+class EditHistory {
+public:
+    static constexpr size_t DEFAULT_LIMIT = 64 * 1024 * 1024;
+
+private:
+    std::deque<Edit> done;     // next undo at the back
+    std::deque<Edit> undone;   // next redo at the back
+    size_t bytes = 0;
+    size_t limit;
+
+    static size_t costOf(const Edit& edit);
+    void trim();
+
+public:
+    explicit EditHistory(size_t limitBytes = DEFAULT_LIMIT) : limit(limitBytes) {}
+
+    // Drops the redo stack. A REPLACE of the paragraph the previous INSERT or REPLACE
+    // produced is folded into that edit, so repeated modifications undo in one step.
+    void record(Edit edit);
+
+    bool canUndo() const { return !done.empty(); }
+    bool canRedo() const { return !undone.empty(); }
+    // Move the edit to the other stack and return it; the caller reverts or reapplies it
+    const Edit& takeUndo();
+    const Edit& takeRedo();
+
+    void clear();
+    void setLimit(size_t limitBytes);
+    size_t getLimit() const { return limit; }
+    // Approximate: edit records plus the text of owned paragraphs they hold
+    size_t getByteSize() const { return bytes; }
+    size_t getUndoCount() const { return done.size(); }
+    size_t getRedoCount() const { return undone.size(); }
+};
+
+#endif // EDIT_HISTORY_H
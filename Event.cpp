@@ -1,11 +1,12 @@
 #include "Event.h"
+#include <cctype>
 #include <sstream>
 
-Event::Event(const Date& d, const std::string& t, EventType et, EventPriority p, const std::string& desc)
-    : date(d), time(std::nullopt), type(et), priority(p), title(t), description(desc) {}
+Event::Event(const Date& d, std::string t, EventType et, EventPriority p, std::string desc)
+    : date(d), time(std::nullopt), type(et), priority(p), title(std::move(t)), description(std::move(desc)) {}
 
-Event::Event(const Date& d, const Time& tm, const std::string& t, EventType et, EventPriority p, const std::string& desc)
-    : date(d), time(tm), type(et), priority(p), title(t), description(desc) {}
+Event::Event(const Date& d, const Time& tm, std::string t, EventType et, EventPriority p, std::string desc)
+    : date(d), time(tm), type(et), priority(p), title(std::move(t)), description(std::move(desc)) {}
 
 bool Event::operator==(const Event& other) const {
     if (date != other.date) return false;
@@ -47,6 +48,10 @@ bool Event::operator>=(const Event& other) const {
     return !(*this < other);
 }
 
+EventKey Event::sortKey() const {
+    return { date.toSerial(), time.has_value() ? time->toSeconds() : 24 * 60 * 60 };
+}
+
 std::string Event::typeToString(EventType type) {
     switch (type) {
     case EventType::MEETING: return "Meeting";
@@ -69,6 +74,37 @@ std::string Event::priorityToString(EventPriority priority) {
     }
 }
 
+static bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::optional<EventType> Event::typeFromString(std::string_view name) {
+    for (EventType type : { EventType::MEETING, EventType::APPOINTMENT, EventType::REMINDER,
+        EventType::DEADLINE, EventType::CELEBRATION, EventType::OTHER }) {
+        if (equalsIgnoreCase(name, typeToString(type))) {
+            return type;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<EventPriority> Event::priorityFromString(std::string_view name) {
+    for (EventPriority priority : { EventPriority::LOW, EventPriority::MEDIUM, EventPriority::HIGH, EventPriority::URGENT }) {
+        if (equalsIgnoreCase(name, priorityToString(priority))) {
+            return priority;
+        }
+    }
+    return std::nullopt;
+}
+
 std::string Event::toString() const {
     std::ostringstream oss;
     oss << "[" << priorityToString(priority) << "] " << title << " (" << typeToString(type) << ")\n";
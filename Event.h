@@ -3,8 +3,11 @@
 
 #include "Date.h"
 #include "Time.h"
+#include "StringPool.h"
 #include <string>
 #include <optional>
+#include <string_view>
+#include <utility>
 
 enum class EventType {
     MEETING,
@@ -22,30 +25,36 @@ enum class EventPriority {
     URGENT
 };
 
+// (day serial, seconds of day); untimed events sort after timed ones on the same day
+using EventKey = std::pair<int, int>;
+
 class Event {
 private:
     Date date;
     std::optional<Time> time; 
     EventType type;
     EventPriority priority;
-    std::string title;
-    std::string description;
+    InternedString title;
+    InternedString description;
 
 public:
 
-    Event(const Date& d, const std::string& t, EventType et = EventType::OTHER,
-        EventPriority p = EventPriority::MEDIUM, const std::string& desc = "");
+    // Text is taken by value: pass an rvalue to hand the buffer over without a copy
+    Event(const Date& d, std::string t, EventType et = EventType::OTHER,
+        EventPriority p = EventPriority::MEDIUM, std::string desc = "");
 
-    Event(const Date& d, const Time& tm, const std::string& t, EventType et = EventType::OTHER,
-        EventPriority p = EventPriority::MEDIUM, const std::string& desc = "");
+    Event(const Date& d, const Time& tm, std::string t, EventType et = EventType::OTHER,
+        EventPriority p = EventPriority::MEDIUM, std::string desc = "");
 
     // Getters
     const Date& getDate() const { return date; }
     const std::optional<Time>& getTime() const { return time; }
     EventType getType() const { return type; }
     EventPriority getPriority() const { return priority; }
-    const std::string& getTitle() const { return title; }
-    const std::string& getDescription() const { return description; }
+    const std::string& getTitle() const { return title.str(); }
+    const std::string& getDescription() const { return description.str(); }
+    const InternedString& getTitleHandle() const { return title; }
+    const InternedString& getDescriptionHandle() const { return description; }
 
     // Setters
     void setDate(const Date& d) { date = d; }
@@ -53,12 +62,16 @@ public:
     void clearTime() { time.reset(); } 
     void setType(EventType t) { type = t; }
     void setPriority(EventPriority p) { priority = p; }
-    void setTitle(const std::string& t) { title = t; }
-    void setDescription(const std::string& d) { description = d; }
+    void setTitle(std::string t) { title = InternedString(std::move(t)); }
+    void setDescription(std::string d) { description = InternedString(std::move(d)); }
+    void setTitle(InternedString t) { title = std::move(t); }
+    void setDescription(InternedString d) { description = std::move(d); }
 
     
     bool hasTime() const { return time.has_value(); }
 
+    EventKey sortKey() const;
+
    
     bool operator==(const Event& other) const;
     bool operator!=(const Event& other) const;
@@ -73,6 +86,9 @@ public:
   
     static std::string typeToString(EventType type);
     static std::string priorityToString(EventPriority priority);
+    // Inverse of typeToString/priorityToString, case-insensitive
+    static std::optional<EventType> typeFromString(std::string_view name);
+    static std::optional<EventPriority> priorityFromString(std::string_view name);
 
     friend std::ostream& operator<<(std::ostream& os, const Event& event);
 };
@@ -0,0 +1,376 @@
+#include "EventArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+void putVarint(std::vector<std::uint8_t>& out, std::uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+std::uint32_t getVarint(const std::uint8_t*& in, const std::uint8_t* end) {
+    std::uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (in == end) {
+            break;
+        }
+        std::uint8_t byte = *in++;
+        value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw std::runtime_error("Corrupt archive segment");
+}
+
+// LZ77 block format in the style of LZ4: each sequence is a token (literal length in the
+// high nibble, match length - 4 in the low nibble, 15 = more length bytes follow), the
+// literals, then a 16-bit match offset. The last sequence carries literals only.
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MAX_OFFSET = 0xFFFF;
+constexpr int HASH_BITS = 12;
+
+void putLength(std::vector<std::uint8_t>& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back(static_cast<std::uint8_t>(length));
+}
+
+void putSequence(std::vector<std::uint8_t>& out, const std::uint8_t* literals, size_t literalLength,
+    size_t offset, size_t matchLength) {
+    size_t matchCode = matchLength >= MIN_MATCH ? matchLength - MIN_MATCH : 0;
+    out.push_back(static_cast<std::uint8_t>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchCode, 15)));
+    if (literalLength >= 15) {
+        putLength(out, literalLength - 15);
+    }
+    out.insert(out.end(), literals, literals + literalLength);
+
+    if (matchLength >= MIN_MATCH) {
+        out.push_back(static_cast<std::uint8_t>(offset & 0xFF));
+        out.push_back(static_cast<std::uint8_t>(offset >> 8));
+        if (matchCode >= 15) {
+            putLength(out, matchCode - 15);
+        }
+    }
+}
+
+std::uint32_t read32(const std::uint8_t* data) {
+    std::uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+std::vector<std::uint8_t> compressBlock(const std::vector<std::uint8_t>& input) {
+    std::vector<std::uint8_t> out;
+    out.reserve(input.size() / 2 + 16);
+
+    const std::uint8_t* data = input.data();
+    const size_t size = input.size();
+    std::vector<std::uint32_t> table(size_t(1) << HASH_BITS, 0);   // position + 1, 0 = empty
+
+    size_t anchor = 0;
+    size_t position = 0;
+    while (position + MIN_MATCH <= size) {
+        std::uint32_t sequence = read32(data + position);
+        std::uint32_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+        size_t candidate = table[hash];
+        table[hash] = static_cast<std::uint32_t>(position + 1);
+
+        if (candidate != 0 && position - (candidate - 1) <= MAX_OFFSET && read32(data + candidate - 1) == sequence) {
+            size_t start = candidate - 1;
+            size_t length = MIN_MATCH;
+            while (position + length < size && data[start + length] == data[position + length]) {
+                ++length;
+            }
+
+            putSequence(out, data + anchor, position - anchor, position - start, length);
+            position += length;
+            anchor = position;
+        }
+        else {
+            ++position;
+        }
+    }
+
+    putSequence(out, data + anchor, size - anchor, 0, 0);
+    return out;
+}
+
+std::vector<std::uint8_t> decompressBlock(const std::vector<std::uint8_t>& input, size_t rawSize) {
+    std::vector<std::uint8_t> out;
+    out.reserve(rawSize);
+
+    const std::uint8_t* in = input.data();
+    const std::uint8_t* end = in + input.size();
+
+    auto getLength = [&](size_t length) {
+        if (length == 15) {
+            std::uint8_t byte;
+            do {
+                if (in == end) {
+                    throw std::runtime_error("Corrupt archive segment");
+                }
+                byte = *in++;
+                length += byte;
+            } while (byte == 255);
+        }
+        return length;
+    };
+
+    while (in < end) {
+        std::uint8_t token = *in++;
+        size_t literalLength = getLength(token >> 4);
+        if (literalLength > static_cast<size_t>(end - in) || out.size() + literalLength > rawSize) {
+            throw std::runtime_error("Corrupt archive segment");
+        }
+        out.insert(out.end(), in, in + literalLength);
+        in += literalLength;
+
+        if (in == end) {
+            break;
+        }
+        if (end - in < 2) {
+            throw std::runtime_error("Corrupt archive segment");
+        }
+        size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+        in += 2;
+        size_t matchLength = getLength(token & 0x0F) + MIN_MATCH;
+        if (offset == 0 || offset > out.size() || out.size() + matchLength > rawSize) {
+            throw std::runtime_error("Corrupt archive segment");
+        }
+
+        // Byte by byte: the source may overlap the bytes being written
+        size_t from = out.size() - offset;
+        for (size_t i = 0; i < matchLength; ++i) {
+            out.push_back(out[from + i]);
+        }
+    }
+
+    if (out.size() != rawSize) {
+        throw std::runtime_error("Corrupt archive segment");
+    }
+    return out;
+}
+
+}
+
+// Segment layout before compression:
+//   varint string count, then each string as varint length + bytes (id 0 is the empty string)
+//   per event: varint day delta, varint seconds (86400 = no time), type | priority << 4,
+//              varint title id, varint description id
+EventArchive::Segment EventArchive::encode(const std::shared_ptr<const Event>* first, const std::shared_ptr<const Event>* last) {
+    std::unordered_map<std::string_view, std::uint32_t> ids;
+    std::vector<std::string_view> strings{ std::string_view() };
+    ids.emplace(std::string_view(), 0);
+
+    auto idOf = [&](const std::string& text) {
+        auto it = ids.find(text);
+        if (it != ids.end()) {
+            return it->second;
+        }
+        std::uint32_t id = static_cast<std::uint32_t>(strings.size());
+        strings.push_back(text);
+        ids.emplace(text, id);
+        return id;
+    };
+
+    std::vector<std::uint8_t> body;
+    int previousDay = (*first)->sortKey().first;
+    for (const std::shared_ptr<const Event>* it = first; it != last; ++it) {
+        const Event& event = **it;
+        EventKey key = event.sortKey();
+
+        putVarint(body, static_cast<std::uint32_t>(key.first - previousDay));
+        putVarint(body, static_cast<std::uint32_t>(key.second));
+        body.push_back(static_cast<std::uint8_t>(static_cast<int>(event.getType()) | static_cast<int>(event.getPriority()) << 4));
+        putVarint(body, idOf(event.getTitle()));
+        putVarint(body, idOf(event.getDescription()));
+        previousDay = key.first;
+    }
+
+    std::vector<std::uint8_t> raw;
+    putVarint(raw, static_cast<std::uint32_t>(strings.size()));
+    for (std::string_view text : strings) {
+        putVarint(raw, static_cast<std::uint32_t>(text.size()));
+        raw.insert(raw.end(), text.begin(), text.end());
+    }
+    raw.insert(raw.end(), body.begin(), body.end());
+
+    Segment segment;
+    segment.firstDay = (*first)->sortKey().first;
+    segment.lastDay = (*(last - 1))->sortKey().first;
+    segment.count = static_cast<std::uint32_t>(last - first);
+    segment.rawSize = static_cast<std::uint32_t>(raw.size());
+    segment.data = compressBlock(raw);
+    return segment;
+}
+
+void EventArchive::decode(const Segment& segment, int firstDay, int lastDay, std::vector<std::shared_ptr<const Event>>& result) {
+    std::vector<std::uint8_t> raw = decompressBlock(segment.data, segment.rawSize);
+    const std::uint8_t* in = raw.data();
+    const std::uint8_t* end = in + raw.size();
+
+    // Decoded events of one segment share their text through InternedString handles
+    std::uint32_t stringCount = getVarint(in, end);
+    std::vector<InternedString> strings;
+    strings.reserve(stringCount);
+    for (std::uint32_t i = 0; i < stringCount; ++i) {
+        std::uint32_t length = getVarint(in, end);
+        if (length > static_cast<size_t>(end - in)) {
+            throw std::runtime_error("Corrupt archive segment");
+        }
+        strings.emplace_back(std::string(reinterpret_cast<const char*>(in), length));
+        in += length;
+    }
+
+    int day = segment.firstDay;
+    for (std::uint32_t i = 0; i < segment.count; ++i) {
+        day += static_cast<int>(getVarint(in, end));
+        std::uint32_t seconds = getVarint(in, end);
+        if (in == end) {
+            throw std::runtime_error("Corrupt archive segment");
+        }
+        std::uint8_t flags = *in++;
+        std::uint32_t title = getVarint(in, end);
+        std::uint32_t description = getVarint(in, end);
+        if (title >= strings.size() || description >= strings.size()) {
+            throw std::runtime_error("Corrupt archive segment");
+        }
+
+        if (day < firstDay) {
+            continue;
+        }
+        if (day > lastDay) {
+            break;
+        }
+
+        EventType type = static_cast<EventType>(flags & 0x0F);
+        EventPriority priority = static_cast<EventPriority>(flags >> 4);
+        std::shared_ptr<Event> event = seconds == 24 * 60 * 60
+            ? std::make_shared<Event>(Date::fromSerial(day), std::string(), type, priority)
+            : std::make_shared<Event>(Date::fromSerial(day), Time(seconds / 3600, seconds / 60 % 60, seconds % 60),
+                std::string(), type, priority);
+        event->setTitle(strings[title]);
+        event->setDescription(strings[description]);
+        result.push_back(std::move(event));
+    }
+}
+
+void EventArchive::add(const std::vector<std::shared_ptr<const Event>>& events) {
+    for (size_t first = 0; first < events.size(); first += SEGMENT_EVENTS) {
+        size_t last = std::min(events.size(), first + SEGMENT_EVENTS);
+        segments.push_back(encode(events.data() + first, events.data() + last));
+    }
+    eventCount += events.size();
+
+    std::stable_sort(segments.begin(), segments.end(),
+        [](const Segment& a, const Segment& b) { return a.firstDay < b.firstDay; });
+}
+
+void EventArchive::clear() {
+    segments.clear();
+    eventCount = 0;
+}
+
+std::vector<std::shared_ptr<const Event>> EventArchive::getEventsInDateRange(const Date& start, const Date& end) const {
+    return collect(start.toSerial(), end.toSerial());
+}
+
+std::vector<std::shared_ptr<const Event>> EventArchive::getAllEvents() const {
+    return collect(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+}
+
+EventArchive::Cursor EventArchive::getCursor() const {
+    return Cursor(*this, std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+}
+
+std::vector<std::shared_ptr<const Event>> EventArchive::collect(int firstDay, int lastDay) const {
+    std::vector<std::shared_ptr<const Event>> result;
+
+    bool overlapping = false;
+    for (const Segment& segment : segments) {
+        if (segment.firstDay > lastDay) {
+            break;
+        }
+        if (segment.lastDay >= firstDay) {
+            // Segments from separate archiving runs may interleave in time, even within a day,
+            // so the full keys either side of each seam are compared
+            size_t seam = result.size();
+            decode(segment, firstDay, lastDay, result);
+            overlapping = overlapping || (seam > 0 && seam < result.size() && result[seam]->sortKey() < result[seam - 1]->sortKey());
+        }
+    }
+
+    if (overlapping) {
+        std::stable_sort(result.begin(), result.end(),
+            [](const std::shared_ptr<const Event>& a, const std::shared_ptr<const Event>& b) {
+                return a->sortKey() < b->sortKey();
+            });
+    }
+    return result;
+}
+
+EventArchive::Cursor::Cursor(const EventArchive& archive, int firstDay, int lastDay)
+    : archive(&archive), firstDay(firstDay), lastDay(lastDay) {
+    fill();
+}
+
+void EventArchive::Cursor::fill() {
+    const std::vector<Segment>& segments = archive->segments;
+    while (segment < segments.size() && segments[segment].firstDay <= lastDay &&
+        (position == buffer.size() || segments[segment].firstDay <= buffer[position]->sortKey().first)) {
+        const Segment& next = segments[segment++];
+        if (next.lastDay < firstDay) {
+            continue;
+        }
+
+        std::vector<std::shared_ptr<const Event>> decoded;
+        decode(next, firstDay, lastDay, decoded);
+        if (position == buffer.size()) {
+            buffer = std::move(decoded);
+        }
+        else {
+            // Segments from separate archiving runs may interleave; earlier segments win ties
+            std::vector<std::shared_ptr<const Event>> merged;
+            merged.reserve(buffer.size() - position + decoded.size());
+            std::merge(buffer.begin() + position, buffer.end(), decoded.begin(), decoded.end(), std::back_inserter(merged),
+                [](const std::shared_ptr<const Event>& a, const std::shared_ptr<const Event>& b) {
+                    return a->sortKey() < b->sortKey();
+                });
+            buffer = std::move(merged);
+        }
+        position = 0;
+    }
+}
+
+std::shared_ptr<const Event> EventArchive::Cursor::next() {
+    std::shared_ptr<const Event> event = std::move(buffer[position++]);
+    if (position == buffer.size()) {
+        buffer.clear();
+        position = 0;
+        fill();
+    }
+    else if (segment < archive->segments.size() && archive->segments[segment].firstDay <= buffer[position]->sortKey().first) {
+        fill();
+    }
+    return event;
+}
+
+size_t EventArchive::compressedSize() const {
+    size_t total = 0;
+    for (const Segment& segment : segments) {
+        total += segment.data.size();
+    }
+    return total;
+}
@@ -0,0 +1,73 @@
+#ifndef EVENT_ARCHIVE_H
+#define EVENT_ARCHIVE_H
+
+#include "Event.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Cold storage for old events. Events are packed into immutable compressed segments:
+// days delta + varint coded, titles and descriptions dictionary coded per segment,
+// the whole segment run through an LZ-style block compressor. Queries decode only
+// the segments whose day span overlaps the window.
+class EventArchive {
+public:
+    static constexpr size_t SEGMENT_EVENTS = 4096;
+
+private:
+    struct Segment {
+        int firstDay;
+        int lastDay;
+        std::uint32_t count;
+        std::uint32_t rawSize;
+        std::vector<std::uint8_t> data;
+    };
+
+    std::vector<Segment> segments;
+    size_t eventCount = 0;
+
+    static Segment encode(const std::shared_ptr<const Event>* first, const std::shared_ptr<const Event>* last);
+    static void decode(const Segment& segment, int firstDay, int lastDay, std::vector<std::shared_ptr<const Event>>& result);
+    std::vector<std::shared_ptr<const Event>> collect(int firstDay, int lastDay) const;
+
+public:
+    // Lazy walk in date and time order over the archived events within a day window.
+    // Segments are decoded only once the walk reaches their first day. Invalidated by
+    // adding to or clearing the archive.
+    class Cursor {
+    private:
+        const EventArchive* archive;
+        size_t segment = 0;       // next segment not yet decoded
+        int firstDay;
+        int lastDay;
+        std::vector<std::shared_ptr<const Event>> buffer;
+        size_t position = 0;
+
+        // Decodes segments until no undecoded one can hold an event ordered before the head
+        void fill();
+
+    public:
+        Cursor(const EventArchive& archive, int firstDay, int lastDay);
+
+        bool hasNext() const { return position < buffer.size(); }
+        EventKey peekKey() const { return buffer[position]->sortKey(); }
+        const std::shared_ptr<const Event>& peek() const { return buffer[position]; }
+        std::shared_ptr<const Event> next();
+    };
+
+    // `events` must be in date and time order
+    void add(const std::vector<std::shared_ptr<const Event>>& events);
+    void clear();
+
+    // Decoded copies in date and time order
+    std::vector<std::shared_ptr<const Event>> getEventsInDateRange(const Date& start, const Date& end) const;
+    std::vector<std::shared_ptr<const Event>> getAllEvents() const;
+    Cursor getCursor(const Date& start, const Date& end) const { return Cursor(*this, start.toSerial(), end.toSerial()); }
+    Cursor getCursor() const;
+
+    size_t size() const { return eventCount; }
+    size_t segmentCount() const { return segments.size(); }
+    size_t compressedSize() const;
+};
+
+#endif // EVENT_ARCHIVE_H
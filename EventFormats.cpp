@@ -0,0 +1,660 @@
+#include "EventFormats.h"
+#include "MappedFile.h"
+#include <cctype>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::toupper(static_cast<unsigned char>(a[i])) != std::toupper(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::runtime_error formatError(const std::string& message, size_t line) {
+    return std::runtime_error(message + " at line " + std::to_string(line));
+}
+
+bool parseNumber(std::string_view text, int& value) {
+    if (text.empty() || text.size() > 9) {
+        return false;
+    }
+    value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+// Date silently falls back to a default on invalid input, so check the round trip
+bool makeDate(int day, int month, int year, Date& date) {
+    date = Date(day, month, year);
+    return date.getDay() == day && date.getMonth() == month && date.getYear() == year;
+}
+
+bool makeTime(int hour, int minute, int second, std::optional<Time>& time) {
+    if (hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59) {
+        return false;
+    }
+    time = Time(hour, minute, second);
+    return true;
+}
+
+// Removes line folds: a line break followed by one space or tab
+std::string unfold(std::string_view text) {
+    std::string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\r' && i + 1 < text.size() && text[i + 1] == '\n') {
+            ++i;
+        }
+        if (text[i] == '\n') {
+            if (i + 1 < text.size() && (text[i + 1] == ' ' || text[i + 1] == '\t')) {
+                ++i;
+            }
+            continue;
+        }
+        result.push_back(text[i]);
+    }
+    return result;
+}
+
+size_t findValueColon(std::string_view line) {
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        if (line[i] == '"') {
+            quoted = !quoted;
+        }
+        else if (line[i] == ':' && !quoted) {
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+// YYYYMMDD or YYYYMMDDTHHMMSS[Z]; times are taken as written, without time-zone conversion
+bool parseIcsDateTime(std::string_view value, Date& date, std::optional<Time>& time) {
+    int year, month, day;
+    if (value.size() < 8 || !parseNumber(value.substr(0, 4), year) || !parseNumber(value.substr(4, 2), month) ||
+        !parseNumber(value.substr(6, 2), day) || !makeDate(day, month, year, date)) {
+        return false;
+    }
+
+    time.reset();
+    if (value.size() == 8) {
+        return true;
+    }
+    if (value.back() == 'Z') {
+        value.remove_suffix(1);
+    }
+
+    int hour, minute, second;
+    return value.size() == 15 && (value[8] == 'T' || value[8] == 't') &&
+        parseNumber(value.substr(9, 2), hour) && parseNumber(value.substr(11, 2), minute) &&
+        parseNumber(value.substr(13, 2), second) && makeTime(hour, minute, second, time);
+}
+
+EventPriority priorityFromIcs(int value) {
+    if (value >= 1 && value <= 2) {
+        return EventPriority::URGENT;
+    }
+    if (value >= 3 && value <= 4) {
+        return EventPriority::HIGH;
+    }
+    if (value >= 6 && value <= 9) {
+        return EventPriority::LOW;
+    }
+    return EventPriority::MEDIUM;
+}
+
+int priorityToIcs(EventPriority priority) {
+    switch (priority) {
+    case EventPriority::URGENT: return 1;
+    case EventPriority::HIGH: return 3;
+    case EventPriority::LOW: return 9;
+    default: return 5;
+    }
+}
+
+// DD.MM.YYYY
+bool parseCsvDate(std::string_view text, Date& date) {
+    size_t first = text.find('.');
+    size_t second = first == std::string_view::npos ? first : text.find('.', first + 1);
+    if (second == std::string_view::npos) {
+        return false;
+    }
+
+    int day, month, year;
+    return parseNumber(text.substr(0, first), day) &&
+        parseNumber(text.substr(first + 1, second - first - 1), month) &&
+        parseNumber(text.substr(second + 1), year) && makeDate(day, month, year, date);
+}
+
+// HH:MM or HH:MM:SS; empty means an all-day event
+bool parseCsvTime(std::string_view text, std::optional<Time>& time) {
+    time.reset();
+    if (text.empty()) {
+        return true;
+    }
+
+    int hour, minute, second = 0;
+    if (text.size() != 5 && text.size() != 8) {
+        return false;
+    }
+    if (text[2] != ':' || !parseNumber(text.substr(0, 2), hour) || !parseNumber(text.substr(3, 2), minute)) {
+        return false;
+    }
+    if (text.size() == 8 && (text[5] != ':' || !parseNumber(text.substr(6, 2), second))) {
+        return false;
+    }
+    return makeTime(hour, minute, second, time);
+}
+
+void writeDate(SinkWriter& out, const Date& date, char separator) {
+    if (separator == 0) {
+        out.number(date.getYear(), 4, '0');
+        out.number(date.getMonth(), 2, '0');
+        out.number(date.getDay(), 2, '0');
+    }
+    else {
+        out.number(date.getDay(), 2, '0');
+        out.put(separator);
+        out.number(date.getMonth(), 2, '0');
+        out.put(separator);
+        out.number(date.getYear(), 4, '0');
+    }
+}
+
+void writeTime(SinkWriter& out, const Time& time, char separator) {
+    out.number(time.getHour(), 2, '0');
+    if (separator != 0) {
+        out.put(separator);
+    }
+    out.number(time.getMinute(), 2, '0');
+    if (separator != 0) {
+        out.put(separator);
+    }
+    out.number(time.getSecond(), 2, '0');
+}
+
+// Escaped TEXT property, folded so that no line exceeds 75 octets
+void writeIcsText(SinkWriter& out, const char* name, const std::string& text) {
+    const size_t maxLine = 75;
+    size_t lineLength = std::char_traits<char>::length(name) + 1;
+    out.write(name, lineLength - 1);
+    out.put(':');
+
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '\r') {
+            continue;
+        }
+
+        char escaped = 0;
+        switch (c) {
+        case '\\': escaped = '\\'; break;
+        case ';': escaped = ';'; break;
+        case ',': escaped = ','; break;
+        case '\n': escaped = 'n'; break;
+        default: break;
+        }
+
+        // Never split an escape sequence or a UTF-8 character across a fold
+        size_t width = escaped ? 2 : c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+        bool continuation = (c & 0xC0) == 0x80;
+        if (!continuation && lineLength + width > maxLine) {
+            out.write("\r\n ", 3);
+            lineLength = 1;
+        }
+
+        if (escaped) {
+            out.put('\\');
+            out.put(escaped);
+        }
+        else {
+            out.put(static_cast<char>(c));
+        }
+        if (!continuation) {
+            lineLength += width;
+        }
+    }
+    out.write("\r\n", 2);
+}
+
+void writeCsvField(SinkWriter& out, const std::string& text) {
+    if (text.find_first_of(",\"\r\n") == std::string::npos) {
+        out.write(text);
+        return;
+    }
+
+    out.put('"');
+    for (char c : text) {
+        if (c == '"') {
+            out.put('"');
+        }
+        out.put(c);
+    }
+    out.put('"');
+}
+
+template <typename Events>
+void writeIcs(Events& events, OutputSink& sink) {
+    SinkWriter out(sink);
+    out.write("BEGIN:VCALENDAR\r\nVERSION:2.0\r\nPRODID:-//lotariev//calendar//EN\r\n");
+
+    size_t sequence = 0;
+    while (events.hasNext()) {
+        std::shared_ptr<const Event> event = events.next();
+
+        out.write("BEGIN:VEVENT\r\nUID:event-");
+        out.number(static_cast<long long>(++sequence));
+        out.write("@lotariev\r\n");
+
+        if (event->hasTime()) {
+            out.write("DTSTART:");
+            writeDate(out, event->getDate(), 0);
+            out.put('T');
+            writeTime(out, *event->getTime(), 0);
+        }
+        else {
+            out.write("DTSTART;VALUE=DATE:");
+            writeDate(out, event->getDate(), 0);
+        }
+        out.write("\r\n", 2);
+
+        writeIcsText(out, "SUMMARY", event->getTitle());
+        if (!event->getDescription().empty()) {
+            writeIcsText(out, "DESCRIPTION", event->getDescription());
+        }
+
+        std::string category = Event::typeToString(event->getType());
+        for (char& c : category) {
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+        out.write("CATEGORIES:");
+        out.write(category);
+        out.write("\r\nPRIORITY:");
+        out.number(priorityToIcs(event->getPriority()));
+        out.write("\r\nEND:VEVENT\r\n");
+    }
+
+    out.write("END:VCALENDAR\r\n");
+    out.flush();
+}
+
+template <typename Events>
+void writeCsv(Events& events, OutputSink& sink) {
+    SinkWriter out(sink);
+    out.write("date,time,type,priority,title,description\r\n");
+
+    while (events.hasNext()) {
+        std::shared_ptr<const Event> event = events.next();
+
+        writeDate(out, event->getDate(), '.');
+        out.put(',');
+        if (event->hasTime()) {
+            writeTime(out, *event->getTime(), ':');
+        }
+        out.put(',');
+        out.write(Event::typeToString(event->getType()));
+        out.put(',');
+        out.write(Event::priorityToString(event->getPriority()));
+        out.put(',');
+        writeCsvField(out, event->getTitle());
+        out.put(',');
+        writeCsvField(out, event->getDescription());
+        out.write("\r\n", 2);
+    }
+    out.flush();
+}
+
+template <typename Reader>
+size_t importFile(Calendar& calendar, const std::string& path) {
+    MappedFile file(path);
+    Reader reader(file.view());
+
+    EventRecord record;
+    size_t added = 0;
+    while (reader.next(record)) {
+        calendar.addEvent(record.toEvent());
+        ++added;
+    }
+    return added;
+}
+
+}
+
+std::string RawText::decode() const {
+    switch (encoding) {
+    case TextEncoding::ICS_TEXT: {
+        std::string unfolded;
+        std::string_view text = raw;
+        if (text.find('\n') != std::string_view::npos) {
+            unfolded = unfold(text);
+            text = unfolded;
+        }
+
+        std::string result;
+        result.reserve(text.size());
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] == '\\' && i + 1 < text.size()) {
+                char next = text[++i];
+                result.push_back(next == 'n' || next == 'N' ? '\n' : next);
+            }
+            else {
+                result.push_back(text[i]);
+            }
+        }
+        return result;
+    }
+    case TextEncoding::CSV_QUOTED: {
+        std::string result;
+        result.reserve(raw.size());
+        for (size_t i = 0; i < raw.size(); ++i) {
+            result.push_back(raw[i]);
+            if (raw[i] == '"' && i + 1 < raw.size() && raw[i + 1] == '"') {
+                ++i;
+            }
+        }
+        return result;
+    }
+    default:
+        return std::string(raw);
+    }
+}
+
+Event EventRecord::toEvent() const {
+    if (time) {
+        return Event(date, *time, title.decode(), type, priority, description.decode());
+    }
+    return Event(date, title.decode(), type, priority, description.decode());
+}
+
+bool IcsReader::nextLine(std::string_view& line, bool& folded) {
+    if (position >= input.size()) {
+        return false;
+    }
+
+    size_t start = position;
+    size_t end;
+    folded = false;
+
+    for (;;) {
+        ++lineNumber;
+        end = input.find('\n', position);
+        if (end == std::string_view::npos) {
+            end = input.size();
+            position = end;
+            break;
+        }
+        position = end + 1;
+        if (position < input.size() && (input[position] == ' ' || input[position] == '\t')) {
+            folded = true;
+            continue;
+        }
+        break;
+    }
+
+    line = input.substr(start, end - start);
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    return true;
+}
+
+bool IcsReader::next(EventRecord& record) {
+    std::string_view line;
+    bool folded;
+    bool inEvent = false;
+    bool hasStart = false;
+    int depth = 0;
+
+    size_t first = lineNumber + 1;
+    while (nextLine(line, folded)) {
+        size_t current = first;
+        first = lineNumber + 1;
+
+        size_t colon = findValueColon(line);
+        if (colon == std::string_view::npos) {
+            continue;
+        }
+
+        std::string header;
+        std::string value;
+        std::string_view headerView = line.substr(0, colon);
+        std::string_view valueView = line.substr(colon + 1);
+        if (folded && headerView.find('\n') != std::string_view::npos) {
+            header = unfold(headerView);
+            headerView = header;
+        }
+        std::string_view name = headerView.substr(0, headerView.find(';'));
+
+        // Short structured values are unfolded eagerly; text stays raw until commit
+        auto structured = [&]() -> std::string_view {
+            if (folded && valueView.find('\n') != std::string_view::npos) {
+                value = unfold(valueView);
+                return value;
+            }
+            return valueView;
+        };
+
+        if (equalsIgnoreCase(name, "BEGIN")) {
+            if (inEvent) {
+                ++depth;
+            }
+            else if (equalsIgnoreCase(structured(), "VEVENT")) {
+                inEvent = true;
+                hasStart = false;
+                record = EventRecord();
+                record.line = current;
+            }
+            continue;
+        }
+        if (equalsIgnoreCase(name, "END")) {
+            if (inEvent && depth > 0) {
+                --depth;
+            }
+            else if (inEvent && equalsIgnoreCase(structured(), "VEVENT")) {
+                if (!hasStart) {
+                    throw formatError("VEVENT without DTSTART", record.line);
+                }
+                return true;
+            }
+            continue;
+        }
+        if (!inEvent || depth > 0) {
+            continue;
+        }
+
+        if (equalsIgnoreCase(name, "DTSTART")) {
+            if (!parseIcsDateTime(structured(), record.date, record.time)) {
+                throw formatError("Invalid DTSTART", current);
+            }
+            hasStart = true;
+        }
+        else if (equalsIgnoreCase(name, "SUMMARY")) {
+            record.title = { valueView, TextEncoding::ICS_TEXT };
+        }
+        else if (equalsIgnoreCase(name, "DESCRIPTION")) {
+            record.description = { valueView, TextEncoding::ICS_TEXT };
+        }
+        else if (equalsIgnoreCase(name, "CATEGORIES")) {
+            std::string_view categories = structured();
+            record.type = Event::typeFromString(categories.substr(0, categories.find(','))).value_or(EventType::OTHER);
+        }
+        else if (equalsIgnoreCase(name, "PRIORITY")) {
+            int priority;
+            if (parseNumber(structured(), priority)) {
+                record.priority = priorityFromIcs(priority);
+            }
+        }
+    }
+
+    if (inEvent) {
+        throw formatError("Unterminated VEVENT", record.line);
+    }
+    return false;
+}
+
+bool CsvReader::nextField(RawText& field, bool& lastInRecord) {
+    size_t end;
+
+    if (position < input.size() && input[position] == '"') {
+        size_t start = ++position;
+        size_t quote;
+        for (;;) {
+            quote = input.find('"', position);
+            if (quote == std::string_view::npos) {
+                throw formatError("Unterminated quoted field", lineNumber);
+            }
+            if (quote + 1 < input.size() && input[quote + 1] == '"') {
+                position = quote + 2;
+                continue;
+            }
+            break;
+        }
+
+        field = { input.substr(start, quote - start), TextEncoding::CSV_QUOTED };
+        for (char c : field.raw) {
+            lineNumber += c == '\n';
+        }
+        end = quote + 1;
+        if (end < input.size() && input[end] == '\r') {
+            ++end;
+        }
+    }
+    else {
+        end = input.find_first_of(",\n", position);
+        if (end == std::string_view::npos) {
+            end = input.size();
+        }
+        field = { input.substr(position, end - position), TextEncoding::PLAIN };
+        if (!field.raw.empty() && field.raw.back() == '\r') {
+            field.raw.remove_suffix(1);
+        }
+    }
+
+    if (end >= input.size()) {
+        position = input.size();
+        lastInRecord = true;
+    }
+    else if (input[end] == ',') {
+        position = end + 1;
+        lastInRecord = false;
+    }
+    else if (input[end] == '\n') {
+        position = end + 1;
+        ++lineNumber;
+        lastInRecord = true;
+    }
+    else {
+        throw formatError("Unexpected character after quoted field", lineNumber);
+    }
+    return true;
+}
+
+bool CsvReader::next(EventRecord& record) {
+    const size_t maxFields = 6;
+
+    for (;;) {
+        if (position < input.size() && input[position] == '\r') {
+            ++position;
+        }
+        if (position >= input.size()) {
+            return false;
+        }
+        if (input[position] == '\n') {
+            ++position;
+            ++lineNumber;
+            continue;
+        }
+
+        size_t line = lineNumber;
+        RawText fields[maxFields];
+        size_t count = 0;
+        bool last = false;
+        while (!last) {
+            RawText field;
+            nextField(field, last);
+            if (count < maxFields) {
+                fields[count] = field;
+            }
+            ++count;
+        }
+
+        if (!started) {
+            started = true;
+            if (fields[0].encoding == TextEncoding::PLAIN && equalsIgnoreCase(fields[0].raw, "date")) {
+                continue;
+            }
+        }
+
+        if (count < maxFields - 1 || count > maxFields) {
+            throw formatError("Expected 5 or 6 fields", line);
+        }
+
+        record = EventRecord();
+        record.line = line;
+        if (!parseCsvDate(fields[0].raw, record.date)) {
+            throw formatError("Invalid date", line);
+        }
+        if (!parseCsvTime(fields[1].raw, record.time)) {
+            throw formatError("Invalid time", line);
+        }
+        if (!fields[2].raw.empty()) {
+            std::optional<EventType> type = Event::typeFromString(fields[2].raw);
+            if (!type) {
+                throw formatError("Unknown event type", line);
+            }
+            record.type = *type;
+        }
+        if (!fields[3].raw.empty()) {
+            std::optional<EventPriority> priority = Event::priorityFromString(fields[3].raw);
+            if (!priority) {
+                throw formatError("Unknown event priority", line);
+            }
+            record.priority = *priority;
+        }
+        record.title = fields[4];
+        if (count == maxFields) {
+            record.description = fields[5];
+        }
+        return true;
+    }
+}
+
+size_t importIcs(Calendar& calendar, const std::string& path) {
+    return importFile<IcsReader>(calendar, path);
+}
+
+size_t importCsv(Calendar& calendar, const std::string& path) {
+    return importFile<CsvReader>(calendar, path);
+}
+
+void exportIcs(EventCursor cursor, OutputSink& sink) {
+    writeIcs(cursor, sink);
+}
+
+void exportCsv(EventCursor cursor, OutputSink& sink) {
+    writeCsv(cursor, sink);
+}
+
+void exportIcs(const Calendar& calendar, const Date& start, const Date& end, OutputSink& sink) {
+    MergedEventCursor events = calendar.getMergedCursor(start, end);
+    writeIcs(events, sink);
+}
+
+void exportCsv(const Calendar& calendar, const Date& start, const Date& end, OutputSink& sink) {
+    MergedEventCursor events = calendar.getMergedCursor(start, end);
+    writeCsv(events, sink);
+}
@@ -0,0 +1,86 @@
+#ifndef EVENT_FORMATS_H
+#define EVENT_FORMATS_H
+
+#include "Calendar.h"
+#include "OutputSink.h"
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+enum class TextEncoding {
+    PLAIN,
+    ICS_TEXT,    // folded lines and backslash escapes
+    CSV_QUOTED   // surrounding quotes and doubled inner quotes
+};
+
+// Field text exactly as it appears in the input buffer
+struct RawText {
+    std::string_view raw;
+    TextEncoding encoding = TextEncoding::PLAIN;
+
+    std::string decode() const;
+};
+
+// One parsed event. Text fields point into the reader's input and stay undecoded
+// until toEvent() copies them, so the input must outlive the record.
+struct EventRecord {
+    Date date;
+    std::optional<Time> time;
+    EventType type = EventType::OTHER;
+    EventPriority priority = EventPriority::MEDIUM;
+    RawText title;
+    RawText description;
+    size_t line = 0;
+
+    Event toEvent() const;
+};
+
+// Single-pass reader of the VEVENTs of an iCalendar stream. DTSTART, SUMMARY, DESCRIPTION,
+// CATEGORIES and PRIORITY are mapped; other properties and nested components are skipped.
+class IcsReader {
+private:
+    std::string_view input;
+    size_t position = 0;
+    size_t lineNumber = 0;
+
+    bool nextLine(std::string_view& line, bool& folded);
+
+public:
+    explicit IcsReader(std::string_view input) : input(input) {}
+
+    // Throws std::runtime_error on a malformed event
+    bool next(EventRecord& record);
+};
+
+// Single-pass reader of CSV records: date,time,type,priority,title[,description].
+// Dates are DD.MM.YYYY, times HH:MM[:SS] or empty; a leading header row is skipped.
+class CsvReader {
+private:
+    std::string_view input;
+    size_t position = 0;
+    size_t lineNumber = 1;
+    bool started = false;
+
+    bool nextField(RawText& field, bool& lastInRecord);
+
+public:
+    explicit CsvReader(std::string_view input) : input(input) {}
+
+    // Throws std::runtime_error on a malformed record
+    bool next(EventRecord& record);
+};
+
+// Import a file through a memory mapping; return the number of events added
+size_t importIcs(Calendar& calendar, const std::string& path);
+size_t importCsv(Calendar& calendar, const std::string& path);
+
+// Events of a cursor in date and time order
+void exportIcs(EventCursor cursor, OutputSink& sink);
+void exportCsv(EventCursor cursor, OutputSink& sink);
+// Everything the calendar shows within [start, end]: single and archived events, and each
+// recurring occurrence as an event of its own. The archive is decoded one segment at a time.
+void exportIcs(const Calendar& calendar, const Date& start, const Date& end, OutputSink& sink);
+void exportCsv(const Calendar& calendar, const Date& start, const Date& end, OutputSink& sink);
+
+#endif // EVENT_FORMATS_H
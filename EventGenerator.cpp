@@ -0,0 +1,88 @@
+#include "EventGenerator.h"
+
+namespace {
+    // MEETING, APPOINTMENT, REMINDER, DEADLINE, CELEBRATION, OTHER
+    const unsigned typeWeights[] = { 35, 15, 20, 10, 5, 15 };
+    // LOW, MEDIUM, HIGH, URGENT
+    const unsigned priorityWeights[] = { 30, 45, 18, 7 };
+    // Monday .. Sunday
+    const unsigned weekdayWeights[] = { 18, 18, 18, 18, 16, 6, 6 };
+
+    const char* const titles[] = {
+        "Team Meeting", "Standup", "1:1", "Sprint Planning", "Retrospective",
+        "Doctor Appointment", "Dentist", "Pay Rent", "Call Mom", "Submit Report",
+        "Project Deadline", "Tax Filing", "Birthday", "Anniversary", "Gym",
+        "Code Review", "Client Call", "Lunch", "Design Review", "All Hands"
+    };
+    const unsigned titleWeights[] = { 20, 18, 10, 6, 5, 3, 2, 2, 3, 4, 3, 1, 4, 1, 6, 5, 4, 3, 2, 1 };
+
+    const char* const descriptions[] = {
+        "", "Discuss project progress", "Bring documents", "Room 101", "Prepare slides"
+    };
+    const unsigned descriptionWeights[] = { 70, 10, 7, 8, 5 };
+
+    template <typename T, size_t N>
+    constexpr size_t countOf(const T (&)[N]) { return N; }
+}
+
+EventGenerator::EventGenerator(std::uint64_t seed, const Date& firstDay, int spanDays)
+    : random(seed), firstDay(firstDay), spanDays(spanDays > 0 ? spanDays : 1) {}
+
+std::uint64_t EventGenerator::uniform(std::uint64_t bound) {
+    return random() % bound;
+}
+
+size_t EventGenerator::weighted(const unsigned* weights, size_t count) {
+    unsigned total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += weights[i];
+    }
+
+    unsigned pick = static_cast<unsigned>(uniform(total));
+    for (size_t i = 0; i < count; ++i) {
+        if (pick < weights[i]) {
+            return i;
+        }
+        pick -= weights[i];
+    }
+    return count - 1;
+}
+
+Event EventGenerator::next() {
+    // Pick a week, then a weekday with weekday-heavy weights
+    int weeks = (spanDays + 6) / 7;
+    int firstMonday = firstDay.toSerial() - (firstDay.toSerial() + 1) % 7;
+    int serial = firstMonday + static_cast<int>(uniform(weeks)) * 7 +
+        static_cast<int>(weighted(weekdayWeights, countOf(weekdayWeights)));
+    if (serial < firstDay.toSerial()) {
+        serial += 7;
+    }
+    Date date = Date::fromSerial(serial);
+
+    EventType type = static_cast<EventType>(weighted(typeWeights, countOf(typeWeights)));
+    EventPriority priority = static_cast<EventPriority>(weighted(priorityWeights, countOf(priorityWeights)));
+    std::string title = titles[weighted(titleWeights, countOf(titleWeights))];
+    std::string description = descriptions[weighted(descriptionWeights, countOf(descriptionWeights))];
+
+    if (type == EventType::CELEBRATION || uniform(100) < 15) {
+        return Event(date, title, type, priority, description);
+    }
+
+    // Business hours cluster around mid-day; quarter-hour starts
+    int hour = 8 + static_cast<int>(uniform(5) + uniform(6));
+    if (type == EventType::REMINDER && uniform(4) == 0) {
+        hour = static_cast<int>(uniform(24));
+    }
+    int minute = static_cast<int>(uniform(4)) * 15;
+
+    return Event(date, Time(hour, minute, 0), title, type, priority, description);
+}
+
+std::vector<Event> EventGenerator::generate(size_t count) {
+    std::vector<Event> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back(next());
+    }
+    return result;
+}
@@ -0,0 +1,30 @@
+#ifndef EVENT_GENERATOR_H
+#define EVENT_GENERATOR_H
+
+#include "Event.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Deterministic synthetic workload: the same seed yields the same events on
+// every platform (no std:: distributions, whose output is implementation-defined)
+class EventGenerator {
+private:
+    std::mt19937_64 random;
+    Date firstDay;
+    int spanDays;
+
+    std::uint64_t uniform(std::uint64_t bound);
+    size_t weighted(const unsigned* weights, size_t count);
+
+public:
+    EventGenerator(std::uint64_t seed = 42, const Date& firstDay = Date(1, 1, 2020), int spanDays = 5 * 365);
+
+    Event next();
+    std::vector<Event> generate(size_t count);
+
+    const Date& getFirstDay() const { return firstDay; }
+    int getSpanDays() const { return spanDays; }
+};
+
+#endif // EVENT_GENERATOR_H
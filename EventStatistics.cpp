@@ -0,0 +1,92 @@
+#include "EventStatistics.h"
+
+namespace {
+
+long long floorShift(long long value, int bits) {
+    return value >= 0 ? value >> bits : -((-value - 1) >> bits) - 1;
+}
+
+}
+
+void EventStatistics::update(const Event& event, std::int32_t delta) {
+    long long key = event.getDate().toSerial();
+    int type = FIRST_TYPE + static_cast<int>(event.getType());
+    int priority = FIRST_PRIORITY + static_cast<int>(event.getPriority());
+    int hour = event.hasTime() ? FIRST_HOUR + event.getTime()->getHour() : -1;
+
+    for (auto& level : levels) {
+        Counters& counters = level.try_emplace(key, Counters{}).first->second;
+        counters[TOTAL] += delta;
+        counters[type] += delta;
+        counters[priority] += delta;
+        if (hour >= 0) {
+            counters[hour] += delta;
+        }
+        // Every event adds to the total, so an empty total means an empty entry
+        if (counters[TOTAL] == 0) {
+            level.erase(key);
+        }
+        key = floorShift(key, LEVEL_BITS);
+    }
+}
+
+void EventStatistics::clear() {
+    for (auto& level : levels) {
+        level.clear();
+    }
+}
+
+// Partial spans at both ends are summed at the finer level; whatever lies between is
+// made of whole spans of the next level up
+EventStatistics::Counters EventStatistics::sum(const Date& start, const Date& end, int firstCounter, int counterCount) const {
+    constexpr long long SPAN = 1LL << LEVEL_BITS;
+    Counters total{};
+    auto add = [&](const std::map<long long, Counters>& level, long long first, long long last) {
+        for (auto it = level.lower_bound(first); it != level.end() && it->first <= last; ++it) {
+            for (int counter = firstCounter; counter < firstCounter + counterCount; ++counter) {
+                total[counter] += it->second[counter];
+            }
+        }
+    };
+
+    long long first = start.toSerial();
+    long long last = end.toSerial();
+    for (int level = 0; first <= last; ++level) {
+        long long firstSpan = floorShift(first - 1, LEVEL_BITS) + 1;
+        long long lastSpan = floorShift(last + 1, LEVEL_BITS) - 1;
+        if (level + 1 == LEVELS || firstSpan > lastSpan) {
+            add(levels[level], first, last);
+            break;
+        }
+        add(levels[level], first, firstSpan * SPAN - 1);
+        add(levels[level], (lastSpan + 1) * SPAN, last);
+        first = firstSpan;
+        last = lastSpan;
+    }
+    return total;
+}
+
+size_t EventStatistics::range(int counter, const Date& start, const Date& end) const {
+    return static_cast<size_t>(sum(start, end, counter, 1)[counter]);
+}
+
+size_t EventStatistics::count(const Date& start, const Date& end) const {
+    return range(TOTAL, start, end);
+}
+
+size_t EventStatistics::countByType(EventType type, const Date& start, const Date& end) const {
+    return range(FIRST_TYPE + static_cast<int>(type), start, end);
+}
+
+size_t EventStatistics::countByPriority(EventPriority priority, const Date& start, const Date& end) const {
+    return range(FIRST_PRIORITY + static_cast<int>(priority), start, end);
+}
+
+std::array<size_t, EventStatistics::HOURS> EventStatistics::countByHour(const Date& start, const Date& end) const {
+    Counters total = sum(start, end, FIRST_HOUR, HOURS);
+    std::array<size_t, HOURS> result{};
+    for (int hour = 0; hour < HOURS; ++hour) {
+        result[hour] = static_cast<size_t>(total[FIRST_HOUR + hour]);
+    }
+    return result;
+}
@@ -0,0 +1,49 @@
+#ifndef EVENT_STATISTICS_H
+#define EVENT_STATISTICS_H
+
+#include "Event.h"
+#include <array>
+#include <cstdint>
+#include <map>
+
+// Event counters aggregated over blocks of 16 days, 16 blocks, and so on: a range count
+// visits at most 15 entries at each end per level. Only days holding events have entries,
+// so memory follows the events rather than the span of dates between them.
+class EventStatistics {
+public:
+    static constexpr int TYPE_COUNT = 6;
+    static constexpr int PRIORITY_COUNT = 4;
+    static constexpr int HOURS = 24;
+
+private:
+    static constexpr int TOTAL = 0;
+    static constexpr int FIRST_TYPE = 1;
+    static constexpr int FIRST_PRIORITY = FIRST_TYPE + TYPE_COUNT;
+    static constexpr int FIRST_HOUR = FIRST_PRIORITY + PRIORITY_COUNT;
+    static constexpr int COUNTERS = FIRST_HOUR + HOURS;
+    static constexpr int LEVEL_BITS = 4;
+    static constexpr int LEVELS = 8;   // a top-level entry spans 2^28 days, so every int serial fits in 16
+
+    using Counters = std::array<std::int32_t, COUNTERS>;
+
+    // levels[k] maps a day serial divided (rounding down) by 16^k to the counters of that span
+    std::array<std::map<long long, Counters>, LEVELS> levels;
+
+    void update(const Event& event, std::int32_t delta);
+    // Counters [first, first + count) summed over the days in [start, end]
+    Counters sum(const Date& start, const Date& end, int first = 0, int count = COUNTERS) const;
+    size_t range(int counter, const Date& start, const Date& end) const;
+
+public:
+    void add(const Event& event) { update(event, 1); }
+    void remove(const Event& event) { update(event, -1); }
+    void clear();
+
+    size_t count(const Date& start, const Date& end) const;
+    size_t countByType(EventType type, const Date& start, const Date& end) const;
+    size_t countByPriority(EventPriority priority, const Date& start, const Date& end) const;
+    // Timed events only, indexed by hour of day
+    std::array<size_t, HOURS> countByHour(const Date& start, const Date& end) const;
+};
+
+#endif // EVENT_STATISTICS_H
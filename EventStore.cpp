@@ -0,0 +1,231 @@
+#include "EventStore.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    std::uint64_t mixSequence(std::uint64_t value) {
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+}
+
+EventStore::Node::Node(const EventKey& key, std::uint64_t sequence, std::shared_ptr<const Event> event,
+    NodePtr left, NodePtr right)
+    : key(key), sequence(sequence), priority(mixSequence(sequence)), event(std::move(event)),
+    left(std::move(left)), right(std::move(right)) {
+    size = 1 + sizeOf(this->left) + sizeOf(this->right);
+}
+
+EventStore::NodePtr EventStore::withChildren(const NodePtr& node, NodePtr left, NodePtr right) {
+    return std::make_shared<const Node>(node->key, node->sequence, node->event, std::move(left), std::move(right));
+}
+
+std::pair<EventStore::NodePtr, EventStore::NodePtr> EventStore::split(const NodePtr& node, const EventKey& key,
+    std::uint64_t sequence) {
+    if (!node) {
+        return { nullptr, nullptr };
+    }
+
+    bool before = node->key < key || (node->key == key && node->sequence < sequence);
+    if (before) {
+        auto parts = split(node->right, key, sequence);
+        return { withChildren(node, node->left, std::move(parts.first)), std::move(parts.second) };
+    }
+
+    auto parts = split(node->left, key, sequence);
+    return { std::move(parts.first), withChildren(node, std::move(parts.second), node->right) };
+}
+
+EventStore::NodePtr EventStore::merge(const NodePtr& left, const NodePtr& right) {
+    if (!left) {
+        return right;
+    }
+    if (!right) {
+        return left;
+    }
+
+    if (left->priority > right->priority) {
+        return withChildren(left, left->left, merge(left->right, right));
+    }
+    return withChildren(right, merge(left, right->left), right->right);
+}
+
+void EventStore::visit(const NodePtr& node, const EventKey& first, const EventKey& last,
+    const std::function<void(const std::shared_ptr<const Event>&)>& visitor) {
+    if (!node) {
+        return;
+    }
+    if (first < node->key) {
+        visit(node->left, first, last, visitor);
+    }
+    if (!(node->key < first) && !(last < node->key)) {
+        visitor(node->event);
+    }
+    if (node->key < last) {
+        visit(node->right, first, last, visitor);
+    }
+}
+
+void EventStore::collect(const NodePtr& node, std::vector<std::shared_ptr<const Event>>& result) {
+    if (!node) {
+        return;
+    }
+    collect(node->left, result);
+    result.push_back(node->event);
+    collect(node->right, result);
+}
+
+// A treap's shape depends only on its nodes, so the node of highest priority is the root of
+// whichever version holds it. Unequal roots mean the higher one is missing from the other side.
+void EventStore::compare(const NodePtr& from, const NodePtr& to,
+    std::vector<std::shared_ptr<const Event>>& removed, std::vector<std::shared_ptr<const Event>>& added) {
+    if (from == to) {
+        return;
+    }
+    if (!from || !to) {
+        collect(from ? from : to, from ? removed : added);
+        return;
+    }
+
+    if (from->sequence == to->sequence) {
+        compare(from->left, to->left, removed, added);
+        compare(from->right, to->right, removed, added);
+    }
+    else if (from->priority > to->priority) {
+        auto parts = split(to, from->key, from->sequence);
+        compare(from->left, parts.first, removed, added);
+        removed.push_back(from->event);
+        compare(from->right, parts.second, removed, added);
+    }
+    else {
+        auto parts = split(from, to->key, to->sequence);
+        compare(parts.first, to->left, removed, added);
+        added.push_back(to->event);
+        compare(parts.second, to->right, removed, added);
+    }
+}
+
+EventStore EventStore::insert(const Event& event) const {
+    return insert(std::make_shared<const Event>(event));
+}
+
+EventStore EventStore::insert(std::shared_ptr<const Event> event) const {
+    EventKey key = event->sortKey();
+    auto parts = split(root, key, nextSequence);
+    NodePtr node = std::make_shared<const Node>(key, nextSequence, std::move(event), nullptr, nullptr);
+    return EventStore(merge(merge(parts.first, node), parts.second), nextSequence + 1);
+}
+
+EventStore EventStore::erase(const Event& event) const {
+    int serial = event.getDate().toSerial();
+    auto head = split(root, { serial, std::numeric_limits<int>::min() }, 0);
+    auto tail = split(head.second, { serial + 1, std::numeric_limits<int>::min() }, 0);
+
+    // Only the events of that single day are rebuilt
+    std::vector<NodePtr> survivors;
+    std::function<void(const NodePtr&)> collect = [&](const NodePtr& node) {
+        if (!node) {
+            return;
+        }
+        collect(node->left);
+        if (!(*node->event == event)) {
+            survivors.push_back(node);
+        }
+        collect(node->right);
+    };
+    collect(tail.first);
+
+    if (survivors.size() == sizeOf(tail.first)) {
+        return *this;
+    }
+
+    NodePtr day;
+    for (const auto& node : survivors) {
+        day = merge(day, std::make_shared<const Node>(node->key, node->sequence, node->event, nullptr, nullptr));
+    }
+
+    return EventStore(merge(merge(head.first, day), tail.second), nextSequence);
+}
+
+void EventStore::forEach(const std::function<void(const std::shared_ptr<const Event>&)>& visitor) const {
+    visit(root, { std::numeric_limits<int>::min(), std::numeric_limits<int>::min() },
+        { std::numeric_limits<int>::max(), std::numeric_limits<int>::max() }, visitor);
+}
+
+std::vector<std::shared_ptr<const Event>> EventStore::getEventsInDateRange(const Date& start, const Date& end) const {
+    std::vector<std::shared_ptr<const Event>> result;
+    visit(root, { start.toSerial(), std::numeric_limits<int>::min() }, { end.toSerial(), std::numeric_limits<int>::max() },
+        [&result](const std::shared_ptr<const Event>& event) { result.push_back(event); });
+    return result;
+}
+
+void EventStore::compare(const EventStore& target, std::vector<std::shared_ptr<const Event>>& removed,
+    std::vector<std::shared_ptr<const Event>>& added) const {
+    compare(root, target.root, removed, added);
+}
+
+CalendarHistory::CalendarHistory(size_t limitVersions, EventStore initial)
+    : versions(1, std::move(initial)), limit(std::max<size_t>(1, limitVersions)) {}
+
+const EventStore& CalendarHistory::asOf(size_t version) const {
+    if (version < firstVersion || version - firstVersion >= versions.size()) {
+        throw std::out_of_range("Version not kept");
+    }
+    return versions[version - firstVersion];
+}
+
+void CalendarHistory::commit(EventStore store) {
+    versions.resize(currentVersion - firstVersion + 1);
+    versions.push_back(std::move(store));
+    ++currentVersion;
+    trim();
+}
+
+// The current version is always kept, even if the redo tail behind it exceeds the limit
+void CalendarHistory::trim() {
+    while (versions.size() > limit && firstVersion < currentVersion) {
+        versions.pop_front();
+        ++firstVersion;
+    }
+}
+
+void CalendarHistory::addEvent(const Event& event) {
+    commit(current().insert(event));
+}
+
+void CalendarHistory::addEvent(std::shared_ptr<const Event> event) {
+    commit(current().insert(std::move(event)));
+}
+
+bool CalendarHistory::removeEvent(const Event& event) {
+    EventStore next = current().erase(event);
+    if (next.size() == current().size()) {
+        return false;
+    }
+    commit(std::move(next));
+    return true;
+}
+
+void CalendarHistory::setLimit(size_t limitVersions) {
+    limit = std::max<size_t>(1, limitVersions);
+    trim();
+}
+
+bool CalendarHistory::undo() {
+    if (!canUndo()) {
+        return false;
+    }
+    --currentVersion;
+    return true;
+}
+
+bool CalendarHistory::redo() {
+    if (!canRedo()) {
+        return false;
+    }
+    ++currentVersion;
+    return true;
+}
@@ -0,0 +1,108 @@
+#ifndef EVENT_STORE_H
+#define EVENT_STORE_H
+
+#include "Event.h"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Immutable event set ordered by date and time. Every mutation returns a new
+// version sharing all untouched nodes with the old one (persistent treap with
+// path copying), so a version costs O(log n) new nodes rather than a full copy.
+class EventStore {
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    struct Node {
+        EventKey key;
+        std::uint64_t sequence;
+        std::uint64_t priority;
+        std::shared_ptr<const Event> event;
+        NodePtr left;
+        NodePtr right;
+        size_t size;
+
+        Node(const EventKey& key, std::uint64_t sequence, std::shared_ptr<const Event> event,
+            NodePtr left, NodePtr right);
+    };
+
+    NodePtr root;
+    std::uint64_t nextSequence = 0;
+
+    EventStore(NodePtr root, std::uint64_t nextSequence) : root(std::move(root)), nextSequence(nextSequence) {}
+
+    static size_t sizeOf(const NodePtr& node) { return node ? node->size : 0; }
+    static NodePtr withChildren(const NodePtr& node, NodePtr left, NodePtr right);
+    // Splits into nodes ordered before (key, sequence) and the rest
+    static std::pair<NodePtr, NodePtr> split(const NodePtr& node, const EventKey& key, std::uint64_t sequence);
+    static NodePtr merge(const NodePtr& left, const NodePtr& right);
+    static void visit(const NodePtr& node, const EventKey& first, const EventKey& last,
+        const std::function<void(const std::shared_ptr<const Event>&)>& visitor);
+    static void collect(const NodePtr& node, std::vector<std::shared_ptr<const Event>>& result);
+    static void compare(const NodePtr& from, const NodePtr& to,
+        std::vector<std::shared_ptr<const Event>>& removed, std::vector<std::shared_ptr<const Event>>& added);
+
+public:
+    EventStore() = default;
+
+    size_t size() const { return sizeOf(root); }
+    bool isEmpty() const { return !root; }
+
+    EventStore insert(const Event& event) const;
+    EventStore insert(std::shared_ptr<const Event> event) const;
+    // Removes every event equal to `event`, as Calendar::removeEvent does
+    EventStore erase(const Event& event) const;
+
+    void forEach(const std::function<void(const std::shared_ptr<const Event>&)>& visitor) const;
+    std::vector<std::shared_ptr<const Event>> getEventsInDateRange(const Date& start, const Date& end) const;
+
+    // Events only in this version go to `removed`, events only in `target` to `added`.
+    // Subtrees the versions share are skipped, so nearby versions compare in O(changes log n).
+    void compare(const EventStore& target, std::vector<std::shared_ptr<const Event>>& removed,
+        std::vector<std::shared_ptr<const Event>>& added) const;
+};
+
+// Linear version history over EventStore snapshots with undo and redo. Calendar records
+// its single events in one when its history is enabled (Calendar::setHistoryLimit).
+// Version numbers never shift; once more than the limit are kept, the oldest are forgotten.
+class CalendarHistory {
+public:
+    static constexpr size_t DEFAULT_LIMIT = 1024;
+
+private:
+    std::deque<EventStore> versions;
+    size_t firstVersion = 0;     // number of versions.front()
+    size_t currentVersion = 0;
+    size_t limit;
+
+    void commit(EventStore store);
+    void trim();
+
+public:
+    explicit CalendarHistory(size_t limitVersions = DEFAULT_LIMIT, EventStore initial = EventStore());
+
+    const EventStore& current() const { return versions[currentVersion - firstVersion]; }
+    // Throws std::out_of_range for versions not yet made or already forgotten
+    const EventStore& asOf(size_t version) const;
+    size_t version() const { return currentVersion; }
+    size_t firstKeptVersion() const { return firstVersion; }
+    size_t versionCount() const { return versions.size(); }
+
+    void addEvent(const Event& event);
+    void addEvent(std::shared_ptr<const Event> event);
+    // No new version is made when nothing matches; returns whether anything was removed
+    bool removeEvent(const Event& event);
+
+    void setLimit(size_t limitVersions);
+    size_t getLimit() const { return limit; }
+
+    bool canUndo() const { return currentVersion > firstVersion; }
+    bool canRedo() const { return currentVersion - firstVersion + 1 < versions.size(); }
+    bool undo();
+    bool redo();
+};
+
+#endif // EVENT_STORE_H
@@ -0,0 +1,211 @@
+#include "EventTextIndex.h"
+#include "WordNormalizer.h"
+#include <algorithm>
+#include <cctype>
+
+void EventTextIndex::PostingList::append(std::uint32_t id) {
+    std::uint32_t delta = count == 0 ? id : id - last;
+    while (delta >= 0x80) {
+        bytes.push_back(static_cast<std::uint8_t>(delta | 0x80));
+        delta >>= 7;
+    }
+    bytes.push_back(static_cast<std::uint8_t>(delta));
+
+    last = id;
+    ++count;
+}
+
+std::vector<std::uint32_t> EventTextIndex::PostingList::decode() const {
+    std::vector<std::uint32_t> result;
+    result.reserve(count);
+
+    std::uint32_t value = 0;
+    std::uint32_t delta = 0;
+    int shift = 0;
+    for (std::uint8_t byte : bytes) {
+        delta |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+        if (byte & 0x80) {
+            shift += 7;
+            continue;
+        }
+        value = result.empty() ? delta : value + delta;
+        result.push_back(value);
+        delta = 0;
+        shift = 0;
+    }
+
+    return result;
+}
+
+template <typename Alive>
+void EventTextIndex::PostingList::compact(Alive alive) {
+    std::vector<std::uint32_t> values = decode();
+
+    bytes.clear();
+    count = 0;
+    dead = 0;
+    last = 0;
+    for (std::uint32_t value : values) {
+        if (alive(value)) {
+            append(value);
+        }
+    }
+}
+
+void EventTextIndex::appendTokens(std::string_view text, std::vector<std::string>& tokens) {
+    auto isSpace = [](char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; };
+
+    size_t position = 0;
+    while (position < text.size()) {
+        while (position < text.size() && isSpace(text[position])) {
+            ++position;
+        }
+        size_t start = position;
+        while (position < text.size() && !isSpace(text[position])) {
+            ++position;
+        }
+        if (position > start) {
+            std::string word = normalizeWord(std::string(text.substr(start, position - start)));
+            if (!word.empty()) {
+                tokens.push_back(std::move(word));
+            }
+        }
+    }
+}
+
+std::vector<std::string> EventTextIndex::tokenize(std::string_view text) {
+    std::vector<std::string> tokens;
+    appendTokens(text, tokens);
+
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+    return tokens;
+}
+
+std::vector<std::string> EventTextIndex::tokenize(const Event& event) {
+    std::vector<std::string> tokens;
+    appendTokens(event.getTitle(), tokens);
+    appendTokens(event.getDescription(), tokens);
+
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+    return tokens;
+}
+
+void EventTextIndex::add(const std::shared_ptr<const Event>& event) {
+    auto inserted = ids.try_emplace(event.get(), Handle{ nextId, 0 });
+    if (inserted.first->second.references++ > 0) {
+        return;
+    }
+    std::uint32_t id = nextId++;
+    eventsById[id] = event;
+
+    for (const auto& token : tokenize(*event)) {
+        postings[token].append(id);
+    }
+}
+
+void EventTextIndex::remove(const std::shared_ptr<const Event>& event) {
+    auto found = ids.find(event.get());
+    if (found == ids.end()) {
+        return;
+    }
+    if (--found->second.references > 0) {
+        return;
+    }
+    std::uint32_t id = found->second.id;
+    ids.erase(found);
+    eventsById.erase(id);
+
+    for (const auto& token : tokenize(*event)) {
+        auto posting = postings.find(token);
+        if (posting == postings.end() || !posting->second.markRemoved()) {
+            continue;
+        }
+
+        posting->second.compact([this](std::uint32_t value) { return eventsById.count(value) > 0; });
+        if (posting->second.isEmpty()) {
+            postings.erase(posting);
+        }
+    }
+}
+
+void EventTextIndex::clear() {
+    postings.clear();
+    eventsById.clear();
+    ids.clear();
+    nextId = 0;
+}
+
+std::vector<std::shared_ptr<const Event>> EventTextIndex::search(const SearchQuery& query) const {
+    std::vector<std::string> terms = tokenize(query.text);
+    std::vector<const PostingList*> lists;
+
+    for (const auto& term : terms) {
+        auto posting = postings.find(term);
+        if (posting != postings.end()) {
+            lists.push_back(&posting->second);
+        }
+        else if (query.mode == SearchMode::ALL_TERMS) {
+            return {};
+        }
+    }
+
+    if (lists.empty()) {
+        return {};
+    }
+
+    std::vector<std::uint32_t> matches;
+    if (query.mode == SearchMode::ALL_TERMS) {
+        // Intersect starting from the rarest term
+        std::sort(lists.begin(), lists.end(),
+            [](const PostingList* a, const PostingList* b) { return a->size() < b->size(); });
+
+        matches = lists.front()->decode();
+        for (size_t i = 1; i < lists.size() && !matches.empty(); ++i) {
+            std::vector<std::uint32_t> next = lists[i]->decode();
+            std::vector<std::uint32_t> common;
+            std::set_intersection(matches.begin(), matches.end(), next.begin(), next.end(), std::back_inserter(common));
+            matches = std::move(common);
+        }
+    }
+    else {
+        for (const PostingList* list : lists) {
+            std::vector<std::uint32_t> next = list->decode();
+            std::vector<std::uint32_t> merged;
+            merged.reserve(matches.size() + next.size());
+            std::set_union(matches.begin(), matches.end(), next.begin(), next.end(), std::back_inserter(merged));
+            matches = std::move(merged);
+        }
+    }
+
+    std::vector<std::shared_ptr<const Event>> result;
+    for (std::uint32_t id : matches) {
+        auto found = eventsById.find(id);
+        if (found == eventsById.end()) {
+            continue;
+        }
+        const std::shared_ptr<const Event>& event = found->second;
+
+        if (query.start && event->getDate() < *query.start) {
+            continue;
+        }
+        if (query.end && event->getDate() > *query.end) {
+            continue;
+        }
+        if (query.type && event->getType() != *query.type) {
+            continue;
+        }
+        result.push_back(event);
+    }
+
+    return result;
+}
+
+size_t EventTextIndex::postingBytes() const {
+    size_t total = 0;
+    for (const auto& entry : postings) {
+        total += entry.second.byteSize();
+    }
+    return total;
+}
@@ -0,0 +1,78 @@
+#ifndef EVENT_TEXT_INDEX_H
+#define EVENT_TEXT_INDEX_H
+
+#include "Event.h"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+enum class SearchMode {
+    ALL_TERMS,
+    ANY_TERM
+};
+
+struct SearchQuery {
+    std::string text;
+    SearchMode mode = SearchMode::ALL_TERMS;
+    std::optional<Date> start;
+    std::optional<Date> end;
+    std::optional<EventType> type;
+};
+
+// Inverted index from normalized title/description words to events.
+// Posting lists are delta + varint encoded; ids only grow, so adding is an append.
+// Removed ids stay in their lists until half of a list is dead, then it is rewritten.
+class EventTextIndex {
+private:
+    class PostingList {
+    private:
+        std::vector<std::uint8_t> bytes;
+        std::uint32_t last = 0;
+        std::uint32_t count = 0;
+        std::uint32_t dead = 0;
+
+    public:
+        void append(std::uint32_t id);
+        std::vector<std::uint32_t> decode() const;
+        // Returns true when the list should be compacted
+        bool markRemoved() { ++dead; return dead * 2 >= count; }
+        template <typename Alive>
+        void compact(Alive alive);
+
+        size_t size() const { return count; }
+        bool isEmpty() const { return count == dead; }
+        size_t byteSize() const { return bytes.size(); }
+    };
+
+    std::unordered_map<std::string, PostingList> postings;
+    std::unordered_map<std::uint32_t, std::shared_ptr<const Event>> eventsById;
+    struct Handle {
+        std::uint32_t id;
+        std::uint32_t references;   // the same event may be added more than once
+    };
+
+    std::unordered_map<const Event*, Handle> ids;
+    std::uint32_t nextId = 0;
+
+    static void appendTokens(std::string_view text, std::vector<std::string>& tokens);
+    static std::vector<std::string> tokenize(std::string_view text);
+    static std::vector<std::string> tokenize(const Event& event);
+
+public:
+    void add(const std::shared_ptr<const Event>& event);
+    void remove(const std::shared_ptr<const Event>& event);
+    void clear();
+
+    // Matching events in insertion order. An event added more than once is listed once,
+    // and stays until it has been removed as many times.
+    std::vector<std::shared_ptr<const Event>> search(const SearchQuery& query) const;
+
+    size_t termCount() const { return postings.size(); }
+    size_t postingBytes() const;
+};
+
+#endif // EVENT_TEXT_INDEX_H
@@ -0,0 +1,134 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Unable to open file: " + path);
+    }
+    file = handle;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize)) {
+        close();
+        throw std::runtime_error("Unable to read file size: " + path);
+    }
+    length = static_cast<size_t>(fileSize.QuadPart);
+    if (length == 0) {
+        return;
+    }
+
+    mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        close();
+        throw std::runtime_error("Unable to map file: " + path);
+    }
+
+    contents = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (contents == nullptr) {
+        close();
+        throw std::runtime_error("Unable to map file: " + path);
+    }
+}
+
+void MappedFile::close() {
+    if (contents != nullptr) {
+        UnmapViewOfFile(contents);
+    }
+    if (mapping != nullptr) {
+        CloseHandle(mapping);
+    }
+    if (file != nullptr) {
+        CloseHandle(file);
+    }
+    contents = nullptr;
+    mapping = nullptr;
+    file = nullptr;
+    length = 0;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : contents(std::exchange(other.contents, nullptr)), length(std::exchange(other.length, 0)),
+    file(std::exchange(other.file, nullptr)), mapping(std::exchange(other.mapping, nullptr)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        contents = std::exchange(other.contents, nullptr);
+        length = std::exchange(other.length, 0);
+        file = std::exchange(other.file, nullptr);
+        mapping = std::exchange(other.mapping, nullptr);
+    }
+    return *this;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("Unable to open file: " + path);
+    }
+
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0) {
+        ::close(descriptor);
+        throw std::runtime_error("Unable to read file size: " + path);
+    }
+    length = static_cast<size_t>(status.st_size);
+
+    if (length > 0) {
+        void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (address == MAP_FAILED) {
+            ::close(descriptor);
+            length = 0;
+            throw std::runtime_error("Unable to map file: " + path);
+        }
+        ::madvise(address, length, MADV_SEQUENTIAL);
+        contents = static_cast<const char*>(address);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(descriptor);
+}
+
+void MappedFile::close() {
+    if (contents != nullptr) {
+        ::munmap(const_cast<char*>(contents), length);
+    }
+    contents = nullptr;
+    length = 0;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : contents(std::exchange(other.contents, nullptr)), length(std::exchange(other.length, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        contents = std::exchange(other.contents, nullptr);
+        length = std::exchange(other.length, 0);
+    }
+    return *this;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
@@ -0,0 +1,87 @@
+#include "OutputSink.h"
+#include <cstring>
+
+void StreamSink::write(const char* data, size_t size) {
+    stream.write(data, static_cast<std::streamsize>(size));
+}
+
+void StringSink::write(const char* data, size_t size) {
+    target.append(data, size);
+}
+
+void StringSink::reserve(size_t size) {
+    target.reserve(target.size() + size);
+}
+
+void BufferSink::write(const char* data, size_t size) {
+    if (written < capacity) {
+        size_t fits = capacity - written < size ? capacity - written : size;
+        std::memcpy(buffer + written, data, fits);
+    }
+    written += size;
+}
+
+void CallbackSink::write(const char* data, size_t size) {
+    callback(data, size);
+}
+
+void SinkWriter::write(const char* data, size_t size) {
+    if (used + size > BUFFER_SIZE) {
+        flush();
+        if (size > BUFFER_SIZE) {
+            sink.write(data, size);
+            return;
+        }
+    }
+    std::memcpy(buffer + used, data, size);
+    used += size;
+}
+
+void SinkWriter::put(char c) {
+    if (used == BUFFER_SIZE) {
+        flush();
+    }
+    buffer[used++] = c;
+}
+
+void SinkWriter::repeat(char c, size_t count) {
+    while (count > 0) {
+        if (used == BUFFER_SIZE) {
+            flush();
+        }
+        size_t chunk = BUFFER_SIZE - used < count ? BUFFER_SIZE - used : count;
+        std::memset(buffer + used, c, chunk);
+        used += chunk;
+        count -= chunk;
+    }
+}
+
+void SinkWriter::number(long long value, int width, char fill) {
+    char digits[24];
+    int length = 0;
+    bool negative = value < 0;
+    unsigned long long magnitude = negative ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+
+    do {
+        digits[length++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    if (negative) {
+        digits[length++] = '-';
+    }
+
+    if (width > length) {
+        repeat(fill, static_cast<size_t>(width - length));
+    }
+    while (length > 0) {
+        put(digits[--length]);
+    }
+}
+
+void SinkWriter::flush() {
+    if (used > 0) {
+        sink.write(buffer, used);
+        used = 0;
+    }
+}
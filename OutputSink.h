@@ -0,0 +1,93 @@
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+
+    virtual void write(const char* data, size_t size) = 0;
+    // Hint that about `size` more bytes will follow
+    virtual void reserve(size_t size) { (void)size; }
+};
+
+class StreamSink : public OutputSink {
+private:
+    std::ostream& stream;
+
+public:
+    explicit StreamSink(std::ostream& stream) : stream(stream) {}
+
+    void write(const char* data, size_t size) override;
+};
+
+class StringSink : public OutputSink {
+private:
+    std::string& target;
+
+public:
+    explicit StringSink(std::string& target) : target(target) {}
+
+    void write(const char* data, size_t size) override;
+    void reserve(size_t size) override;
+};
+
+// Fills a caller-owned buffer; output that does not fit is counted but dropped
+class BufferSink : public OutputSink {
+private:
+    char* buffer;
+    size_t capacity;
+    size_t written = 0;
+
+public:
+    BufferSink(char* buffer, size_t capacity) : buffer(buffer), capacity(capacity) {}
+
+    void write(const char* data, size_t size) override;
+
+    size_t size() const { return written < capacity ? written : capacity; }
+    size_t requiredSize() const { return written; }
+    bool truncated() const { return written > capacity; }
+};
+
+class CallbackSink : public OutputSink {
+private:
+    std::function<void(const char*, size_t)> callback;
+
+public:
+    explicit CallbackSink(std::function<void(const char*, size_t)> callback) : callback(std::move(callback)) {}
+
+    void write(const char* data, size_t size) override;
+};
+
+// Small fixed buffer in front of a sink, so renderers can emit many tiny pieces cheaply.
+// Call flush() when done: the destructor drops unflushed output rather than writing to a
+// sink that may just have thrown.
+class SinkWriter {
+private:
+    static constexpr size_t BUFFER_SIZE = 4096;
+
+    OutputSink& sink;
+    char buffer[BUFFER_SIZE];
+    size_t used = 0;
+
+public:
+    explicit SinkWriter(OutputSink& sink) : sink(sink) {}
+
+    SinkWriter(const SinkWriter&) = delete;
+    SinkWriter& operator=(const SinkWriter&) = delete;
+
+    void write(const char* data, size_t size);
+    void write(std::string_view text) { write(text.data(), text.size()); }
+    void put(char c);
+    void repeat(char c, size_t count);
+    // Right-aligned and padded with `fill` to `width`, like std::setw
+    void number(long long value, int width = 0, char fill = ' ');
+    void flush();
+};
+
+#endif // OUTPUT_SINK_H
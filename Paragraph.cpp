@@ -0,0 +1,63 @@
+#include "Paragraph.h"
+#include <cstring>
+
+namespace {
+
+// Calls `line(first, last, more)` for each line of mapped bytes without its "\n" or "\r\n";
+// `more` is false for the last line, whose '\r' (if any) preceded a newline in the file too
+template <typename Line>
+void forEachLine(const char* current, const char* end, Line line) {
+    while (true) {
+        const char* newline = static_cast<const char*>(std::memchr(current, '\n', end - current));
+        const char* last = newline ? newline : end;
+        line(current, last > current && last[-1] == '\r' ? last - 1 : last, newline != nullptr);
+        if (!newline) {
+            return;
+        }
+        current = newline + 1;
+    }
+}
+
+}
+
+Paragraph::Paragraph(std::string text)
+    : owned(std::make_shared<const std::string>(std::move(text))) {
+    data = owned->data();
+    length = owned->size();
+}
+
+Paragraph Paragraph::view(std::string_view bytes) {
+    Paragraph paragraph;
+    paragraph.data = bytes.data();
+    paragraph.length = bytes.size();
+    return paragraph;
+}
+
+std::string Paragraph::str() const {
+    if (!isMapped()) {
+        return owned ? *owned : std::string();
+    }
+    std::string result;
+    result.reserve(length);
+    forEachLine(data, data + length, [&result](const char* first, const char* last, bool more) {
+        result.append(first, last);
+        if (more) {
+            result.push_back(' ');
+        }
+    });
+    return result;
+}
+
+std::ostream& operator<<(std::ostream& out, const Paragraph& paragraph) {
+    if (!paragraph.isMapped()) {
+        return out.write(paragraph.data, static_cast<std::streamsize>(paragraph.length));
+    }
+
+    forEachLine(paragraph.data, paragraph.data + paragraph.length, [&out](const char* first, const char* last, bool more) {
+        out.write(first, last - first);
+        if (more) {
+            out.put(' ');
+        }
+    });
+    return out;
+}
@@ -0,0 +1,33 @@
+#ifndef PARAGRAPH_H
+#define PARAGRAPH_H
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Immutable paragraph text, cheap to copy. Either a view of mapped file bytes whose
+// line breaks ("\n" or "\r\n") read as spaces, or a string of its own.
+class Paragraph {
+private:
+    const char* data = nullptr;
+    size_t length = 0;
+    std::shared_ptr<const std::string> owned;
+
+public:
+    Paragraph() = default;
+    Paragraph(std::string text);
+    // `bytes` must outlive the paragraph and all of its copies
+    static Paragraph view(std::string_view bytes);
+
+    bool isMapped() const { return !owned && length != 0; }
+    size_t size() const { return length; }
+    std::string str() const;
+    // Raw bytes; line breaks of a mapped paragraph are still "\n" or "\r\n"
+    std::string_view bytes() const { return std::string_view(data, length); }
+
+    friend std::ostream& operator<<(std::ostream& out, const Paragraph& paragraph);
+};
+
+#endif // PARAGRAPH_H
@@ -0,0 +1,106 @@
+#include "ParagraphPager.h"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+ParagraphPager::ParagraphPager(const std::string& path, size_t windowBudget)
+    : file(path, std::ios::binary), budget(windowBudget) {
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    buildIndex();
+}
+
+void ParagraphPager::buildIndex() {
+    std::vector<char> block(READ_BLOCK);
+    ParagraphScanner scanner;
+    while (file.read(block.data(), static_cast<std::streamsize>(block.size())) || file.gcount() > 0) {
+        scanner.feed(block.data(), static_cast<size_t>(file.gcount()));
+    }
+    extents = scanner.finish();
+    extents.shrink_to_fit();
+    file.clear();
+}
+
+void ParagraphPager::read(size_t first, size_t last, std::deque<Paragraph>& into) {
+    if (first >= last) {
+        return;
+    }
+
+    std::uint64_t start = extents[first].offset;
+    std::string bytes(static_cast<size_t>(extents[last - 1].offset + extents[last - 1].length - start), '\0');
+    file.seekg(static_cast<std::streamoff>(start));
+    if (!file.read(&bytes[0], static_cast<std::streamsize>(bytes.size()))) {
+        file.clear();
+        throw std::runtime_error("Cannot read paragraphs from file");
+    }
+    ++reads;
+
+    // Line breaks become the single spaces the stream loader joins lines with
+    std::string_view view(bytes);
+    for (size_t i = first; i < last; ++i) {
+        std::string_view raw = view.substr(static_cast<size_t>(extents[i].offset - start), static_cast<size_t>(extents[i].length));
+        into.push_back(Paragraph(Paragraph::view(raw).str()));
+    }
+}
+
+void ParagraphPager::slide(size_t index) {
+    // A quarter of the window is kept on the side the reader came from, the rest is read ahead
+    bool backward = !window.empty() && index < windowFirst;
+    size_t first = index;
+    size_t last = index + 1;
+    size_t bytes = static_cast<size_t>(extents[index].length);
+
+    auto fits = [&](size_t i) {
+        if (last - first >= WINDOW_PARAGRAPHS || bytes + extents[i].length > budget) {
+            return false;
+        }
+        bytes += static_cast<size_t>(extents[i].length);
+        return true;
+    };
+    auto growBehind = [&](size_t count) {
+        for (; count > 0 && first > 0 && fits(first - 1); --count) {
+            --first;
+        }
+    };
+    auto growAhead = [&](size_t count) {
+        for (; count > 0 && last < extents.size() && fits(last); --count) {
+            ++last;
+        }
+    };
+
+    if (backward) {
+        growAhead(WINDOW_PARAGRAPHS / 4);
+        growBehind(WINDOW_PARAGRAPHS);
+    }
+    else {
+        growBehind(WINDOW_PARAGRAPHS / 4);
+        growAhead(WINDOW_PARAGRAPHS);
+    }
+
+    size_t keptFirst = std::max(first, windowFirst);
+    size_t keptLast = std::min(last, windowFirst + window.size());
+    std::deque<Paragraph> next;
+    if (keptFirst < keptLast) {
+        read(first, keptFirst, next);
+        std::move(window.begin() + (keptFirst - windowFirst), window.begin() + (keptLast - windowFirst), std::back_inserter(next));
+        read(keptLast, last, next);
+    }
+    else {
+        read(first, last, next);
+    }
+
+    window = std::move(next);
+    windowFirst = first;
+    windowBytes = bytes;
+}
+
+const Paragraph& ParagraphPager::get(size_t index) {
+    if (index >= extents.size()) {
+        throw std::out_of_range("Paragraph index out of range");
+    }
+    if (index < windowFirst || index >= windowFirst + window.size()) {
+        slide(index);
+    }
+    return window[index - windowFirst];
+}
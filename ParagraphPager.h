@@ -0,0 +1,52 @@
+#ifndef PARAGRAPH_PAGER_H
+#define PARAGRAPH_PAGER_H
+
+#include "Paragraph.h"
+#include "ParagraphScanner.h"
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Paragraphs of a file that is never loaded whole. Opening builds only an index of
+// where each paragraph lies; the text is read on demand into a window of neighbouring
+// paragraphs that slides as other paragraphs are requested.
+class ParagraphPager {
+public:
+    static constexpr size_t DEFAULT_WINDOW_BYTES = 4 * 1024 * 1024;
+    static constexpr size_t WINDOW_PARAGRAPHS = 256;
+    static constexpr size_t READ_BLOCK = 1024 * 1024;
+
+private:
+    std::ifstream file;
+    std::vector<ParagraphSpan> extents;
+    std::deque<Paragraph> window;
+    size_t windowFirst = 0;
+    size_t windowBytes = 0;
+    size_t budget;
+    size_t reads = 0;
+
+    void buildIndex();
+    void read(size_t first, size_t last, std::deque<Paragraph>& into);
+    // Re-centres the window on `index`, keeping the paragraphs the old window already holds
+    void slide(size_t index);
+
+public:
+    explicit ParagraphPager(const std::string& path, size_t windowBudget = DEFAULT_WINDOW_BYTES);
+
+    ParagraphPager(const ParagraphPager&) = delete;
+    ParagraphPager& operator=(const ParagraphPager&) = delete;
+
+    size_t size() const { return extents.size(); }
+    // Valid until a paragraph outside the current window is requested
+    const Paragraph& get(size_t index);
+
+    size_t getWindowFirst() const { return windowFirst; }
+    size_t getWindowSize() const { return window.size(); }
+    size_t getWindowBytes() const { return windowBytes; }
+    size_t getIndexBytes() const { return extents.capacity() * sizeof(ParagraphSpan); }
+    size_t getReadCount() const { return reads; }
+};
+
+#endif // PARAGRAPH_PAGER_H
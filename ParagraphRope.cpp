@@ -0,0 +1,266 @@
+#include "ParagraphRope.h"
+#include "ParagraphPager.h"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+ParagraphCursor::ParagraphCursor(const ParagraphRope& rope, size_t first) : rope(&rope), index(first) {
+    if (index < rope.size()) {
+        enter();
+    }
+}
+
+void ParagraphCursor::enter() {
+    size_t chunkStart;
+    const ParagraphRope::Node* node = rope->locate(index, chunkStart);
+    chunk = &node->items;
+    runFirst = node->runFirst;
+    length = ParagraphRope::lengthOf(*node);
+    offset = index - chunkStart;
+}
+
+bool ParagraphCursor::hasNext() const {
+    return index < rope->size();
+}
+
+const Paragraph& ParagraphCursor::peek() const {
+    return chunk->empty() ? rope->pager->get(runFirst + offset) : (*chunk)[offset];
+}
+
+const Paragraph& ParagraphCursor::next() {
+    const Paragraph& paragraph = peek();
+    ++index;
+    if (++offset == length && index < rope->size()) {
+        enter();
+    }
+    return paragraph;
+}
+
+ParagraphRope::ParagraphRope(std::vector<Paragraph> paragraphs) {
+    for (size_t first = 0; first < paragraphs.size(); first += CHUNK_SIZE) {
+        size_t last = std::min(paragraphs.size(), first + CHUNK_SIZE);
+        std::vector<Paragraph> items(std::make_move_iterator(paragraphs.begin() + first),
+            std::make_move_iterator(paragraphs.begin() + last));
+        root = merge(std::move(root), makeNode(std::move(items)));
+    }
+}
+
+ParagraphRope::ParagraphRope(std::shared_ptr<ParagraphPager> pager) : pager(std::move(pager)) {
+    if (this->pager->size() > 0) {
+        root = makeRun(0, this->pager->size());
+    }
+}
+
+ParagraphRope::ParagraphRope(const ParagraphRope& other)
+    : root(copyTree(other.root.get())), pager(other.pager), seed(other.seed) {}
+
+ParagraphRope& ParagraphRope::operator=(const ParagraphRope& other) {
+    if (this != &other) {
+        root = copyTree(other.root.get());
+        pager = other.pager;
+        seed = other.seed;
+    }
+    return *this;
+}
+
+std::unique_ptr<ParagraphRope::Node> ParagraphRope::copyTree(const Node* node) {
+    if (!node) {
+        return nullptr;
+    }
+    auto copy = std::make_unique<Node>();
+    copy->items = node->items;
+    copy->runFirst = node->runFirst;
+    copy->runLength = node->runLength;
+    copy->count = node->count;
+    copy->priority = node->priority;
+    copy->left = copyTree(node->left.get());
+    copy->right = copyTree(node->right.get());
+    return copy;
+}
+
+std::unique_ptr<ParagraphRope::Node> ParagraphRope::makeNode(std::vector<Paragraph> items) {
+    // xorshift32
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    auto node = std::make_unique<Node>();
+    node->items = std::move(items);
+    node->count = node->items.size();
+    node->priority = seed;
+    return node;
+}
+
+std::unique_ptr<ParagraphRope::Node> ParagraphRope::makeRun(size_t first, size_t length) {
+    std::unique_ptr<Node> node = makeNode({});
+    node->runFirst = first;
+    node->runLength = length;
+    node->count = length;
+    return node;
+}
+
+void ParagraphRope::update(Node& node) {
+    node.count = countOf(node.left) + lengthOf(node) + countOf(node.right);
+}
+
+// `count` always falls on a chunk boundary, so no chunk is ever cut in two
+void ParagraphRope::split(std::unique_ptr<Node> node, size_t count, std::unique_ptr<Node>& left, std::unique_ptr<Node>& right) {
+    if (!node) {
+        left.reset();
+        right.reset();
+        return;
+    }
+
+    size_t leftCount = countOf(node->left);
+    if (count <= leftCount) {
+        split(std::move(node->left), count, left, node->left);
+        update(*node);
+        right = std::move(node);
+    }
+    else {
+        split(std::move(node->right), count - leftCount - lengthOf(*node), node->right, right);
+        update(*node);
+        left = std::move(node);
+    }
+}
+
+std::unique_ptr<ParagraphRope::Node> ParagraphRope::merge(std::unique_ptr<Node> left, std::unique_ptr<Node> right) {
+    if (!left) {
+        return right;
+    }
+    if (!right) {
+        return left;
+    }
+
+    if (left->priority > right->priority) {
+        left->right = merge(std::move(left->right), std::move(right));
+        update(*left);
+        return left;
+    }
+    right->left = merge(std::move(left), std::move(right->left));
+    update(*right);
+    return right;
+}
+
+ParagraphRope::Node* ParagraphRope::locate(size_t index, size_t& chunkStart) const {
+    Node* node = root.get();
+    chunkStart = 0;
+    while (node) {
+        size_t leftCount = countOf(node->left);
+        if (index < leftCount) {
+            node = node->left.get();
+        }
+        else if (index < leftCount + lengthOf(*node)) {
+            chunkStart += leftCount;
+            return node;
+        }
+        else {
+            chunkStart += leftCount + lengthOf(*node);
+            index -= leftCount + lengthOf(*node);
+            node = node->right.get();
+        }
+    }
+    throw std::out_of_range("Paragraph index out of range");
+}
+
+std::unique_ptr<ParagraphRope::Node> ParagraphRope::takeChunk(size_t index, size_t& chunkStart, std::unique_ptr<Node>& after) {
+    size_t last = index == size() ? index - 1 : index;
+    size_t chunkSize = lengthOf(*locate(last, chunkStart));
+
+    std::unique_ptr<Node> rest;
+    std::unique_ptr<Node> chunk;
+    split(std::move(root), chunkStart, root, rest);
+    split(std::move(rest), chunkSize, chunk, after);
+    if (chunk->runLength > 0) {
+        chunk = loadRun(std::move(chunk), last - chunkStart, chunkStart, after);
+    }
+    return chunk;
+}
+
+// Chunks are cut from the start of the run, so the last one ends where the run does
+std::unique_ptr<ParagraphRope::Node> ParagraphRope::loadRun(std::unique_ptr<Node> run, size_t offset, size_t& chunkStart, std::unique_ptr<Node>& after) {
+    size_t first = offset - offset % CHUNK_SIZE;
+    size_t last = std::min(run->runLength, first + CHUNK_SIZE);
+
+    std::vector<Paragraph> items;
+    items.reserve(last - first);
+    for (size_t i = first; i < last; ++i) {
+        items.push_back(pager->get(run->runFirst + i));
+    }
+
+    if (first > 0) {
+        root = merge(std::move(root), makeRun(run->runFirst, first));
+    }
+    if (last < run->runLength) {
+        after = merge(makeRun(run->runFirst + last, run->runLength - last), std::move(after));
+    }
+    chunkStart += first;
+    return makeNode(std::move(items));
+}
+
+void ParagraphRope::putChunk(std::unique_ptr<Node> chunk, std::unique_ptr<Node> after) {
+    if (chunk->items.size() > 2 * CHUNK_SIZE) {
+        std::vector<Paragraph> tail(std::make_move_iterator(chunk->items.begin() + CHUNK_SIZE),
+            std::make_move_iterator(chunk->items.end()));
+        chunk->items.resize(CHUNK_SIZE);
+        update(*chunk);
+        root = merge(std::move(root), std::move(chunk));
+        root = merge(std::move(root), makeNode(std::move(tail)));
+    }
+    else if (!chunk->items.empty()) {
+        update(*chunk);
+        root = merge(std::move(root), std::move(chunk));
+    }
+    root = merge(std::move(root), std::move(after));
+}
+
+const Paragraph& ParagraphRope::at(size_t index) const {
+    size_t chunkStart;
+    const Node* node = locate(index, chunkStart);
+    if (node->runLength > 0) {
+        return pager->get(node->runFirst + index - chunkStart);
+    }
+    return node->items[index - chunkStart];
+}
+
+void ParagraphRope::insert(size_t index, Paragraph paragraph) {
+    if (index > size()) {
+        throw std::out_of_range("Paragraph index out of range");
+    }
+    if (!root) {
+        root = makeNode({ std::move(paragraph) });
+        return;
+    }
+
+    size_t chunkStart;
+    std::unique_ptr<Node> after;
+    std::unique_ptr<Node> chunk = takeChunk(index, chunkStart, after);
+    chunk->items.insert(chunk->items.begin() + (index - chunkStart), std::move(paragraph));
+    putChunk(std::move(chunk), std::move(after));
+}
+
+void ParagraphRope::erase(size_t index) {
+    if (index >= size()) {
+        throw std::out_of_range("Paragraph index out of range");
+    }
+
+    size_t chunkStart;
+    std::unique_ptr<Node> after;
+    std::unique_ptr<Node> chunk = takeChunk(index, chunkStart, after);
+    chunk->items.erase(chunk->items.begin() + (index - chunkStart));
+    putChunk(std::move(chunk), std::move(after));
+}
+
+void ParagraphRope::replace(size_t index, Paragraph paragraph) {
+    size_t chunkStart;
+    Node* node = locate(index, chunkStart);
+    if (node->runLength == 0) {
+        node->items[index - chunkStart] = std::move(paragraph);
+        return;
+    }
+
+    std::unique_ptr<Node> after;
+    std::unique_ptr<Node> chunk = takeChunk(index, chunkStart, after);
+    chunk->items[index - chunkStart] = std::move(paragraph);
+    putChunk(std::move(chunk), std::move(after));
+}
@@ -0,0 +1,98 @@
+#ifndef PARAGRAPH_ROPE_H
+#define PARAGRAPH_ROPE_H
+
+#include "Paragraph.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class ParagraphPager;
+class ParagraphRope;
+
+// Forward walk over a rope from a given paragraph.
+// Invalidated by inserting, erasing or replacing paragraphs in that rope.
+class ParagraphCursor {
+private:
+    const ParagraphRope* rope;
+    size_t index;
+    const std::vector<Paragraph>* chunk = nullptr;   // empty for a run of paged paragraphs
+    size_t runFirst = 0;
+    size_t length = 0;
+    size_t offset = 0;
+
+    void enter();
+
+public:
+    ParagraphCursor(const ParagraphRope& rope, size_t first);
+
+    bool hasNext() const;
+    size_t getIndex() const { return index; }
+    // A paged paragraph stays valid until another paragraph outside the pager's window is read
+    const Paragraph& peek() const;
+    const Paragraph& next();
+};
+
+// Sequence of paragraphs kept as an implicit treap of small chunks: access, insert,
+// erase and replace at any index are O(log n), with the paragraphs themselves stored
+// contiguously inside each chunk. A rope over a pager starts as a single run standing for
+// all of the pager's paragraphs; only the chunks that are edited are ever read into it.
+class ParagraphRope {
+private:
+    static constexpr size_t CHUNK_SIZE = 128;   // chunks split above twice this
+
+    struct Node {
+        std::vector<Paragraph> items;
+        size_t runFirst = 0;    // a run has no items and stands for pager paragraphs
+        size_t runLength = 0;   // [runFirst, runFirst + runLength)
+        size_t count = 0;   // paragraphs in this subtree
+        std::uint32_t priority = 0;
+        std::unique_ptr<Node> left;
+        std::unique_ptr<Node> right;
+    };
+
+    std::unique_ptr<Node> root;
+    std::shared_ptr<ParagraphPager> pager;
+    std::uint32_t seed = 0x9E3779B9u;
+
+    static size_t countOf(const std::unique_ptr<Node>& node) { return node ? node->count : 0; }
+    static size_t lengthOf(const Node& node) { return node.items.size() + node.runLength; }
+    static void update(Node& node);
+    static void split(std::unique_ptr<Node> node, size_t count, std::unique_ptr<Node>& left, std::unique_ptr<Node>& right);
+    static std::unique_ptr<Node> merge(std::unique_ptr<Node> left, std::unique_ptr<Node> right);
+    static std::unique_ptr<Node> copyTree(const Node* node);
+
+    std::unique_ptr<Node> makeNode(std::vector<Paragraph> items);
+    std::unique_ptr<Node> makeRun(size_t first, size_t length);
+    // Chunk holding `index` and the position of its first paragraph
+    Node* locate(size_t index, size_t& chunkStart) const;
+    // Detaches the chunk holding `index` (or the last chunk for index == size()) so it can be edited
+    std::unique_ptr<Node> takeChunk(size_t index, size_t& chunkStart, std::unique_ptr<Node>& after);
+    void putChunk(std::unique_ptr<Node> chunk, std::unique_ptr<Node> after);
+    // Reads the chunk of a detached run holding `offset`, putting the rest of the run back around it
+    std::unique_ptr<Node> loadRun(std::unique_ptr<Node> run, size_t offset, size_t& chunkStart, std::unique_ptr<Node>& after);
+
+    friend class ParagraphCursor;
+
+public:
+    ParagraphRope() = default;
+    explicit ParagraphRope(std::vector<Paragraph> paragraphs);
+    explicit ParagraphRope(std::shared_ptr<ParagraphPager> pager);
+    ParagraphRope(const ParagraphRope& other);
+    ParagraphRope(ParagraphRope&& other) noexcept = default;
+    ParagraphRope& operator=(const ParagraphRope& other);
+    ParagraphRope& operator=(ParagraphRope&& other) noexcept = default;
+
+    size_t size() const { return countOf(root); }
+    bool empty() const { return !root; }
+
+    // A paged paragraph stays valid until another paragraph outside the pager's window is read
+    const Paragraph& at(size_t index) const;
+    void insert(size_t index, Paragraph paragraph);
+    void erase(size_t index);
+    void replace(size_t index, Paragraph paragraph);
+    void pushBack(Paragraph paragraph) { insert(size(), std::move(paragraph)); }
+
+    ParagraphCursor getCursor(size_t first = 0) const { return ParagraphCursor(*this, first); }
+};
+
+#endif // PARAGRAPH_ROPE_H
@@ -0,0 +1,234 @@
+#include "ParagraphScanner.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <thread>
+
+#if defined(__AVX2__)
+#define PARAGRAPH_SCANNER_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARAGRAPH_SCANNER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+#if defined(PARAGRAPH_SCANNER_AVX2) || defined(PARAGRAPH_SCANNER_SSE2)
+inline unsigned lowestBit(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+#if defined(PARAGRAPH_SCANNER_AVX2)
+using Vector = __m256i;
+constexpr ptrdiff_t VECTOR_BYTES = 32;
+
+inline Vector load(const char* bytes) { return _mm256_loadu_si256(reinterpret_cast<const Vector*>(bytes)); }
+inline Vector equal(Vector v, char c) { return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)); }
+inline Vector both(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+inline Vector either(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+inline unsigned lanes(Vector v) { return static_cast<unsigned>(_mm256_movemask_epi8(v)); }
+#elif defined(PARAGRAPH_SCANNER_SSE2)
+using Vector = __m128i;
+constexpr ptrdiff_t VECTOR_BYTES = 16;
+
+inline Vector load(const char* bytes) { return _mm_loadu_si128(reinterpret_cast<const Vector*>(bytes)); }
+inline Vector equal(Vector v, char c) { return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); }
+inline Vector both(Vector a, Vector b) { return _mm_and_si128(a, b); }
+inline Vector either(Vector a, Vector b) { return _mm_or_si128(a, b); }
+inline unsigned lanes(Vector v) { return static_cast<unsigned>(_mm_movemask_epi8(v)); }
+#endif
+
+#if defined(PARAGRAPH_SCANNER_AVX2) || defined(PARAGRAPH_SCANNER_SSE2)
+// Lane i is set where byte i is a newline followed by "\n" or "\r\n"; reads VECTOR_BYTES + 2 bytes
+inline Vector emptyLines(const char* bytes) {
+    Vector next = load(bytes + 1);
+    Vector ending = either(equal(next, '\n'), both(equal(next, '\r'), equal(load(bytes + 2), '\n')));
+    return both(equal(load(bytes), '\n'), ending);
+}
+#endif
+
+// First newline in [current, end) that is followed by an empty line ("\n" or "\r\n"), or end
+const char* findEmptyLine(const char* current, const char* end) {
+#if defined(PARAGRAPH_SCANNER_AVX2) || defined(PARAGRAPH_SCANNER_SSE2)
+    // Four vectors per test while there is nothing to find, then one at a time to locate it
+    for (; end - current > 4 * VECTOR_BYTES + 1; current += 4 * VECTOR_BYTES) {
+        Vector first = either(emptyLines(current), emptyLines(current + VECTOR_BYTES));
+        Vector second = either(emptyLines(current + 2 * VECTOR_BYTES), emptyLines(current + 3 * VECTOR_BYTES));
+        if (lanes(either(first, second)) != 0) {
+            break;
+        }
+    }
+    for (; end - current > VECTOR_BYTES + 1; current += VECTOR_BYTES) {
+        unsigned found = lanes(emptyLines(current));
+        if (found != 0) {
+            return current + lowestBit(found);
+        }
+    }
+#endif
+
+    while (end - current > 1) {
+        const char* found = static_cast<const char*>(std::memchr(current, '\n', end - current - 1));
+        if (!found) {
+            break;
+        }
+        if (found[1] == '\n' || (found[1] == '\r' && end - found > 2 && found[2] == '\n')) {
+            return found;
+        }
+        current = found + 1;
+    }
+    return end;
+}
+
+}
+
+void ParagraphScanner::feed(const char* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    const char* end = data + size;
+    const char* current = data;
+    // An empty line split across blocks: "\n" then "\n" or "\r\n", or "\n\r" then "\n"
+    if (inParagraph && lineEnd != LineEnd::NONE) {
+        bool split = lineEnd == LineEnd::NEWLINE
+            ? *data == '\n' || (size > 1 && data[0] == '\r' && data[1] == '\n')
+            : *data == '\n';
+        if (split) {
+            std::uint64_t newline = offset - (lineEnd == LineEnd::NEWLINE ? 1 : 2);
+            spans.push_back({ paragraphStart, newline - paragraphStart });
+            inParagraph = false;
+        }
+    }
+
+    // A '\r' that ended the last block outside a paragraph starts one unless "\n" follows
+    if (carriageReturnPending) {
+        carriageReturnPending = false;
+        if (*data != '\n') {
+            paragraphStart = offset - 1;
+            inParagraph = true;
+        }
+    }
+
+    while (current < end) {
+        if (!inParagraph) {
+            // Only empty lines lie between paragraphs; any other '\r' belongs to the text
+            while (current < end && (*current == '\n' || (*current == '\r' && end - current > 1 && current[1] == '\n'))) {
+                current += *current == '\n' ? 1 : 2;
+            }
+            if (current == end) {
+                break;
+            }
+            if (*current == '\r' && current + 1 == end) {
+                carriageReturnPending = true;
+                break;
+            }
+            paragraphStart = offset + (current - data);
+            inParagraph = true;
+        }
+
+        const char* emptyLine = findEmptyLine(current, end);
+        if (emptyLine == end) {
+            break;
+        }
+        spans.push_back({ paragraphStart, offset + (emptyLine - data) - paragraphStart });
+        inParagraph = false;
+        current = emptyLine + 1;
+    }
+
+    if (end[-1] == '\n') {
+        lineEnd = LineEnd::NEWLINE;
+    }
+    else if (end[-1] == '\r' && (size > 1 ? end[-2] == '\n' : lineEnd == LineEnd::NEWLINE)) {
+        lineEnd = LineEnd::NEWLINE_CR;
+    }
+    else {
+        lineEnd = LineEnd::NONE;
+    }
+    offset += size;
+}
+
+std::vector<ParagraphSpan> ParagraphScanner::finish() {
+    // The last line ends the paragraph, less its newline; a final "\r" after it is an empty line
+    if (inParagraph) {
+        std::uint64_t lineBreak = lineEnd == LineEnd::NEWLINE ? 1 : lineEnd == LineEnd::NEWLINE_CR ? 2 : 0;
+        spans.push_back({ paragraphStart, offset - lineBreak - paragraphStart });
+        inParagraph = false;
+    }
+    carriageReturnPending = false;
+    return std::move(spans);
+}
+
+// Slices start at line starts, so every byte between the last paragraph of one slice and
+// the first of the next is a line break or an empty line, and the two are one paragraph
+// unless at least two newlines (an empty line) lie between them
+std::vector<ParagraphSpan> ParagraphScanner::scan(std::string_view bytes, unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t sliceCount = std::max<size_t>(1, std::min<size_t>(threads, bytes.size() / MIN_THREAD_BYTES));
+    size_t sliceSize = bytes.size() / sliceCount;
+    std::vector<size_t> edges(sliceCount + 1, bytes.size());
+    edges[0] = 0;
+    for (size_t slice = 1; slice < sliceCount; ++slice) {
+        size_t newline = bytes.find('\n', std::max(slice * sliceSize, edges[slice - 1]));
+        edges[slice] = newline == std::string_view::npos ? bytes.size() : newline + 1;
+    }
+
+    std::vector<std::vector<ParagraphSpan>> slices(sliceCount);
+    std::vector<std::exception_ptr> failures(sliceCount);
+    auto work = [&](size_t slice) {
+        try {
+            size_t first = edges[slice];
+            size_t last = edges[slice + 1];
+            ParagraphScanner scanner(first);
+            scanner.feed(bytes.data() + first, last - first);
+            slices[slice] = scanner.finish();
+        }
+        catch (...) {
+            failures[slice] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(sliceCount - 1);
+    for (size_t slice = 1; slice < sliceCount; ++slice) {
+        workers.emplace_back(work, slice);
+    }
+    work(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const std::exception_ptr& failure : failures) {
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    std::vector<ParagraphSpan> spans = std::move(slices[0]);
+    for (size_t slice = 1; slice < sliceCount; ++slice) {
+        auto next = slices[slice].begin();
+        if (next != slices[slice].end() && !spans.empty()) {
+            ParagraphSpan& last = spans.back();
+            std::string_view gap = bytes.substr(static_cast<size_t>(last.offset + last.length),
+                static_cast<size_t>(next->offset - (last.offset + last.length)));
+            if (std::count(gap.begin(), gap.end(), '\n') < 2) {
+                last.length = next->offset + next->length - last.offset;
+                ++next;
+            }
+        }
+        spans.insert(spans.end(), next, slices[slice].end());
+    }
+    return spans;
+}
@@ -0,0 +1,45 @@
+#ifndef PARAGRAPH_SCANNER_H
+#define PARAGRAPH_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Bytes of one paragraph: from the start of its first line to the end of its last
+struct ParagraphSpan {
+    std::uint64_t offset;
+    std::uint64_t length;
+};
+
+// Finds paragraphs (runs of non-empty lines) in text fed to it in consecutive blocks.
+// Lines may end in "\n" or "\r\n"; empty lines are found as a newline followed by "\n"
+// or "\r\n", 32 or 16 bytes at a time where AVX2 or SSE2 is available and through memchr
+// otherwise. A span may end in the '\r' of its last line.
+class ParagraphScanner {
+public:
+    static constexpr size_t MIN_THREAD_BYTES = 16 * 1024 * 1024;
+
+private:
+    enum class LineEnd { NONE, NEWLINE, NEWLINE_CR };
+
+    std::vector<ParagraphSpan> spans;
+    std::uint64_t offset;               // of the next byte fed
+    std::uint64_t paragraphStart = 0;
+    bool inParagraph = false;
+    bool carriageReturnPending = false; // a '\r' ended the last block between paragraphs
+    LineEnd lineEnd = LineEnd::NONE;    // last bytes fed, for an empty line split across blocks
+
+public:
+    explicit ParagraphScanner(std::uint64_t firstOffset = 0) : offset(firstOffset) {}
+
+    void feed(const char* data, size_t size);
+    // Ends the last paragraph and hands over every span found
+    std::vector<ParagraphSpan> finish();
+
+    // Scans `bytes` in slices of at least MIN_THREAD_BYTES on up to `threads` workers
+    // (0 = hardware concurrency) and joins paragraphs cut at slice edges
+    static std::vector<ParagraphSpan> scan(std::string_view bytes, unsigned threads = 0);
+};
+
+#endif // PARAGRAPH_SCANNER_H
@@ -0,0 +1,197 @@
+#include "QueryCache.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// Heap held by an event copy (an archive or occurrence copy) that only the result refers to:
+// the event and its two text entries, each with a shared_ptr control block. Occurrences
+// share their master's text, so they are charged a little more than they hold.
+size_t ownedBytes(const Event& event) {
+    return sizeof(Event) + 2 * sizeof(std::string) + 6 * sizeof(void*) +
+        event.getTitle().capacity() + event.getDescription().capacity();
+}
+
+}
+
+QueryCache::QueryCache(size_t budgetBytes) : budget(budgetBytes) {}
+
+QueryCache::QueryCache(const QueryCache& other) : budget(other.getBudget()) {}
+
+QueryCache& QueryCache::operator=(const QueryCache& other) {
+    if (this != &other) {
+        clear();
+        setBudget(other.getBudget());
+    }
+    return *this;
+}
+
+int QueryCache::monthOf(int daySerial) {
+    Date date = Date::fromSerial(daySerial);
+    return date.getYear() * 12 + date.getMonth() - 1;
+}
+
+bool QueryCache::isCurrent(const QueryKey& key, const Entry& entry) const {
+    switch (key.kind) {
+    case QueryKind::TYPE:
+        return typeGenerations[key.first] <= entry.generation;
+    case QueryKind::PRIORITY:
+        return priorityGenerations[key.first] <= entry.generation;
+    default:
+        // Only months that were ever edited have a generation
+        for (auto it = monthGenerations.lower_bound(entry.firstMonth);
+            it != monthGenerations.end() && it->first <= entry.lastMonth; ++it) {
+            if (it->second > entry.generation) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+void QueryCache::erase(std::unordered_map<QueryKey, Entry, QueryKeyHash>::iterator it) {
+    bytes -= it->second.bytes;
+    recent.erase(it->second.position);
+    entries.erase(it);
+    if (entries.empty()) {
+        monthGenerations.clear();
+    }
+}
+
+void QueryCache::pruneMonths() {
+    std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+    for (const auto& entry : entries) {
+        oldest = std::min(oldest, entry.second.generation);
+    }
+    for (auto it = monthGenerations.begin(); it != monthGenerations.end();) {
+        if (it->second <= oldest) {
+            it = monthGenerations.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    if (monthGenerations.size() > MAX_MONTH_GENERATIONS) {
+        stats.invalidations += entries.size();
+        entries.clear();
+        recent.clear();
+        bytes = 0;
+        monthGenerations.clear();
+    }
+}
+
+void QueryCache::evict() {
+    size_t limit = getBudget();
+    while (bytes > limit && !recent.empty()) {
+        erase(entries.find(recent.back()));
+        ++stats.evictions;
+    }
+}
+
+void QueryCache::setBudget(size_t budgetBytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    budget.store(budgetBytes, std::memory_order_relaxed);
+    evict();
+}
+
+bool QueryCache::find(const QueryKey& key, Result& result) {
+    if (!isEnabled()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        ++stats.misses;
+        return false;
+    }
+    if (!isCurrent(key, it->second)) {
+        erase(it);
+        ++stats.invalidations;
+        ++stats.misses;
+        return false;
+    }
+
+    recent.splice(recent.begin(), recent, it->second.position);
+    result = it->second.result;
+    ++stats.hits;
+    return true;
+}
+
+void QueryCache::store(const QueryKey& key, const Result& result) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    // Pointer storage and bookkeeping, plus the copies the calendar does not hold itself,
+    // which the cache alone keeps alive once the caller lets the result go
+    size_t cost = sizeof(Entry) + sizeof(QueryKey) + 4 * sizeof(void*) + result.size() * sizeof(std::shared_ptr<const Event>);
+    for (const auto& event : result) {
+        if (event.use_count() == 1) {
+            cost += ownedBytes(*event);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (cost > getBudget()) {
+        return;
+    }
+
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        erase(it);
+    }
+
+    Entry entry;
+    entry.result = result;
+    entry.generation = generation;
+    entry.firstMonth = key.kind == QueryKind::TYPE || key.kind == QueryKind::PRIORITY ? 0 : monthOf(key.first);
+    entry.lastMonth = key.kind == QueryKind::TYPE || key.kind == QueryKind::PRIORITY ? 0 : monthOf(key.last);
+    entry.bytes = cost;
+    recent.push_front(key);
+    entry.position = recent.begin();
+    entries.emplace(key, std::move(entry));
+    bytes += cost;
+
+    evict();
+}
+
+void QueryCache::touch(const Event& event) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (entries.empty()) {
+        return;
+    }
+    ++generation;
+    monthGenerations[event.getDate().getYear() * 12 + event.getDate().getMonth() - 1] = generation;
+    if (monthGenerations.size() > MAX_MONTH_GENERATIONS) {
+        pruneMonths();
+    }
+    typeGenerations[static_cast<int>(event.getType())] = generation;
+    priorityGenerations[static_cast<int>(event.getPriority())] = generation;
+}
+
+void QueryCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    recent.clear();
+    bytes = 0;
+    monthGenerations.clear();
+}
+
+QueryCache::Stats QueryCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats result = stats;
+    result.entries = entries.size();
+    result.bytes = bytes;
+    return result;
+}
+
+void QueryCache::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    stats = Stats();
+}
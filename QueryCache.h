@@ -0,0 +1,113 @@
+#ifndef QUERY_CACHE_H
+#define QUERY_CACHE_H
+
+#include "Event.h"
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+enum class QueryKind {
+    DAY,
+    WEEK,
+    MONTH,
+    RANGE,
+    TYPE,
+    PRIORITY
+};
+
+// Date queries carry their day serials; TYPE and PRIORITY carry the enum value in `first`
+struct QueryKey {
+    QueryKind kind;
+    int first;
+    int last;
+
+    bool operator==(const QueryKey& other) const {
+        return kind == other.kind && first == other.first && last == other.last;
+    }
+};
+
+struct QueryKeyHash {
+    size_t operator()(const QueryKey& key) const {
+        std::uint64_t value = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.first)) << 32) |
+            static_cast<std::uint32_t>(key.last);
+        return std::hash<std::uint64_t>()(value * 31 + static_cast<std::uint64_t>(key.kind));
+    }
+};
+
+// LRU cache of query results within a byte budget. Edits bump a generation per month,
+// type and priority bucket; an entry is stale once any bucket it depends on has a newer
+// generation than the entry itself, so edits only cost the results they can change.
+class QueryCache {
+public:
+    struct Stats {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t invalidations = 0;
+        std::uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+    };
+
+private:
+    using Result = std::vector<std::shared_ptr<const Event>>;
+
+    struct Entry {
+        Result result;
+        std::uint64_t generation;
+        int firstMonth;
+        int lastMonth;
+        size_t bytes;
+        std::list<QueryKey>::iterator position;
+    };
+
+    static constexpr int TYPE_COUNT = 6;
+    static constexpr int PRIORITY_COUNT = 4;
+    static constexpr size_t MAX_MONTH_GENERATIONS = 4096;
+
+    mutable std::mutex mutex;
+    std::atomic<size_t> budget;
+    std::unordered_map<QueryKey, Entry, QueryKeyHash> entries;
+    std::list<QueryKey> recent;   // most recently used first
+    size_t bytes = 0;
+
+    std::uint64_t generation = 0;
+    std::map<int, std::uint64_t> monthGenerations;   // year * 12 + month - 1
+    std::uint64_t typeGenerations[TYPE_COUNT] = {};
+    std::uint64_t priorityGenerations[PRIORITY_COUNT] = {};
+    Stats stats;
+
+    static int monthOf(int daySerial);
+    bool isCurrent(const QueryKey& key, const Entry& entry) const;
+    void erase(std::unordered_map<QueryKey, Entry, QueryKeyHash>::iterator it);
+    void evict();
+    // Forgets month generations no entry is older than; drops every entry if too many remain
+    void pruneMonths();
+
+public:
+    // A budget of 0 disables the cache
+    explicit QueryCache(size_t budgetBytes = 0);
+    // Copies start empty with the same budget
+    QueryCache(const QueryCache& other);
+    QueryCache& operator=(const QueryCache& other);
+
+    void setBudget(size_t budgetBytes);
+    size_t getBudget() const { return budget.load(std::memory_order_relaxed); }
+    bool isEnabled() const { return getBudget() != 0; }
+
+    bool find(const QueryKey& key, Result& result);
+    void store(const QueryKey& key, const Result& result);
+
+    // Invalidates the month, type and priority buckets of an added or removed event
+    void touch(const Event& event);
+    void clear();
+
+    Stats getStats() const;
+    void resetStats();
+};
+
+#endif // QUERY_CACHE_H
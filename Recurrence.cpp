@@ -0,0 +1,136 @@
+#include "Recurrence.h"
+#include <algorithm>
+
+namespace {
+
+int daysInMonth(int month, int year) {
+    static const int days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    bool leap = (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+    return month == 2 && leap ? 29 : days[month - 1];
+}
+
+}
+
+RecurrenceRule::RecurrenceRule(RecurrenceFrequency frequency, int interval)
+    : frequency(frequency), interval(std::max(1, interval)) {}
+
+void RecurrenceRule::setWeekdays(std::initializer_list<int> isoWeekdays) {
+    weekdays = 0;
+    for (int weekday : isoWeekdays) {
+        if (weekday >= 1 && weekday <= 7) {
+            weekdays |= 1u << (weekday - 1);
+        }
+    }
+}
+
+void RecurrenceRule::setMonthDay(int day) {
+    if (day >= 1 && day <= 31) {
+        monthDay = day;
+        weekOrdinal = 0;
+    }
+}
+
+void RecurrenceRule::setNthWeekday(int ordinal, int isoWeekday) {
+    if ((ordinal == -1 || (ordinal >= 1 && ordinal <= 5)) && isoWeekday >= 1 && isoWeekday <= 7) {
+        weekOrdinal = ordinal;
+        ordinalWeekday = isoWeekday;
+        monthDay = 0;
+    }
+}
+
+std::vector<Date> RecurrenceRule::occurrences(const Date& start, const Date& from, const Date& to) const {
+    std::vector<Date> result;
+
+    int startSerial = start.toSerial();
+    int first = std::max(from.toSerial(), startSerial);
+    int last = to.toSerial();
+    if (until) {
+        last = std::min(last, until->toSerial());
+    }
+    if (first > last || (count && *count <= 0)) {
+        return result;
+    }
+
+    // A counted series has to be walked from its start; otherwise whole periods
+    // before the window are skipped arithmetically
+    bool skip = !count;
+    int produced = 0;
+    bool finished = false;
+
+    auto accept = [&](int serial) {
+        if (serial < startSerial) {
+            return;
+        }
+        if (serial > last || (count && ++produced > *count)) {
+            finished = true;
+            return;
+        }
+        if (serial >= first && exceptions.count(serial) == 0) {
+            result.push_back(Date::fromSerial(serial));
+        }
+    };
+
+    Date firstDate = Date::fromSerial(first);
+
+    switch (frequency) {
+    case RecurrenceFrequency::DAILY: {
+        int period = skip ? (first - startSerial) / interval : 0;
+        for (int serial = startSerial + period * interval; !finished; serial += interval) {
+            accept(serial);
+        }
+        break;
+    }
+    case RecurrenceFrequency::WEEKLY: {
+        unsigned mask = weekdays != 0 ? weekdays : 1u << (start.getIsoWeekday() - 1);
+        int monday = startSerial - (start.getIsoWeekday() - 1);
+        int span = 7 * interval;
+        int period = skip ? (first - monday) / span : 0;
+        for (int week = monday + period * span; !finished; week += span) {
+            for (int day = 0; day < 7 && !finished; ++day) {
+                if (mask & (1u << day)) {
+                    accept(week + day);
+                }
+            }
+        }
+        break;
+    }
+    case RecurrenceFrequency::MONTHLY: {
+        int startIndex = start.getYear() * 12 + start.getMonth() - 1;
+        int firstIndex = firstDate.getYear() * 12 + firstDate.getMonth() - 1;
+        int period = skip ? (firstIndex - startIndex) / interval : 0;
+        for (int monthIndex = startIndex + period * interval; !finished; monthIndex += interval) {
+            int year = monthIndex / 12;
+            int month = monthIndex % 12 + 1;
+            int monthStart = Date(1, month, year).toSerial();
+            if (monthStart > last) {
+                break;
+            }
+
+            int days = daysInMonth(month, year);
+            int day = monthDay != 0 ? monthDay : start.getDay();
+            if (weekOrdinal != 0) {
+                int firstMatch = (ordinalWeekday - Date(1, month, year).getIsoWeekday() + 7) % 7 + 1;
+                day = weekOrdinal > 0 ? firstMatch + 7 * (weekOrdinal - 1) : firstMatch + 7 * ((days - firstMatch) / 7);
+            }
+            if (day <= days) {
+                accept(monthStart + day - 1);
+            }
+        }
+        break;
+    }
+    case RecurrenceFrequency::YEARLY: {
+        int period = skip ? (firstDate.getYear() - start.getYear()) / interval : 0;
+        for (int year = start.getYear() + period * interval; !finished; year += interval) {
+            if (Date(1, 1, year).toSerial() > last) {
+                break;
+            }
+            if (start.getDay() <= daysInMonth(start.getMonth(), year)) {
+                accept(Date(start.getDay(), start.getMonth(), year).toSerial());
+            }
+        }
+        break;
+    }
+    }
+
+    return result;
+}
@@ -0,0 +1,49 @@
+#ifndef RECURRENCE_H
+#define RECURRENCE_H
+
+#include "Date.h"
+#include <initializer_list>
+#include <optional>
+#include <set>
+#include <vector>
+
+enum class RecurrenceFrequency {
+    DAILY,
+    WEEKLY,
+    MONTHLY,
+    YEARLY
+};
+
+// Repetition pattern of a master event, expanded on demand for a date window
+class RecurrenceRule {
+private:
+    RecurrenceFrequency frequency;
+    int interval;
+    unsigned weekdays = 0;     // WEEKLY: bit 0 = Monday ... bit 6 = Sunday; 0 = weekday of the start
+    int monthDay = 0;          // MONTHLY: day of month; 0 = day of the start
+    int weekOrdinal = 0;       // MONTHLY: 1..5 or -1 for the last such weekday; 0 = unused
+    int ordinalWeekday = 1;    // MONTHLY: 1 = Monday ... 7 = Sunday
+    std::optional<int> count;
+    std::optional<Date> until;
+    std::set<int> exceptions;  // day serials
+
+public:
+    RecurrenceRule(RecurrenceFrequency frequency = RecurrenceFrequency::WEEKLY, int interval = 1);
+
+    RecurrenceFrequency getFrequency() const { return frequency; }
+    int getInterval() const { return interval; }
+
+    void setWeekdays(std::initializer_list<int> isoWeekdays);
+    void setMonthDay(int day);
+    void setNthWeekday(int ordinal, int isoWeekday);
+    void setCount(int occurrences) { count = occurrences; }
+    void setUntil(const Date& last) { until = last; }
+    void addException(const Date& date) { exceptions.insert(date.toSerial()); }
+
+    // Occurrences of a series starting at `start` that fall within [from, to].
+    // Days that do not exist in a period (31 April, 29 February, a fifth Monday) are skipped;
+    // exceptions still count towards the occurrence limit.
+    std::vector<Date> occurrences(const Date& start, const Date& from, const Date& to) const;
+};
+
+#endif // RECURRENCE_H
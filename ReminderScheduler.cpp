@@ -0,0 +1,327 @@
+#include "ReminderScheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <limits>
+
+Timestamp toTimestamp(const Date& date, const Time& time) {
+    return static_cast<Timestamp>(date.toSerial()) * 86400 + time.toSeconds();
+}
+
+Timestamp SystemClock::now() const {
+    std::time_t seconds = std::time(nullptr);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    return toTimestamp(Date(local.tm_mday, local.tm_mon + 1, local.tm_year + 1900),
+        Time(local.tm_hour, local.tm_min, std::min(local.tm_sec, 59)));
+}
+
+void SystemClock::waitUntil(Timestamp deadline) {
+    Timestamp remaining = deadline - now();
+    std::unique_lock<std::mutex> lock(mutex);
+    if (remaining > 0 && !woken) {
+        condition.wait_for(lock, std::chrono::seconds(remaining), [this] { return woken; });
+    }
+    woken = false;
+}
+
+void SystemClock::wake() {
+    std::lock_guard<std::mutex> lock(mutex);
+    woken = true;
+    condition.notify_all();
+}
+
+VirtualClock::VirtualClock(Timestamp start) : current(start) {}
+
+void VirtualClock::advanceTo(Timestamp time) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (time > current) {
+        current = time;
+    }
+    condition.notify_all();
+}
+
+void VirtualClock::advanceBy(long long seconds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (seconds > 0) {
+        current += seconds;
+    }
+    condition.notify_all();
+}
+
+Timestamp VirtualClock::now() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return current;
+}
+
+void VirtualClock::waitUntil(Timestamp deadline) {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this, deadline] { return woken || current >= deadline; });
+    woken = false;
+}
+
+void VirtualClock::wake() {
+    std::lock_guard<std::mutex> lock(mutex);
+    woken = true;
+    condition.notify_all();
+}
+
+ReminderScheduler::ReminderScheduler(std::shared_ptr<Clock> clock)
+    : clock(std::move(clock)) {
+    std::fill(std::begin(heads), std::end(heads), NIL);
+    currentTick = this->clock->now();
+    dispatchedTick = currentTick;
+}
+
+ReminderScheduler::~ReminderScheduler() {
+    stop();
+}
+
+std::uint32_t ReminderScheduler::allocateTimer() {
+    if (freeList != NIL) {
+        std::uint32_t index = freeList;
+        freeList = timers[index].next;
+        timers[index].next = NIL;
+        return index;
+    }
+    timers.emplace_back();
+    return static_cast<std::uint32_t>(timers.size() - 1);
+}
+
+void ReminderScheduler::link(std::uint32_t index) {
+    Timer& timer = timers[index];
+    Timestamp expires = std::max(timer.expires, currentTick);
+
+    int slot = OVERFLOW_SLOT;
+    for (int level = 0; level < LEVELS; ++level) {
+        int shift = WHEEL_BITS * (level + 1);
+        if ((expires >> shift) == (currentTick >> shift)) {
+            slot = level * WHEEL_SIZE + static_cast<int>((expires >> (WHEEL_BITS * level)) & (WHEEL_SIZE - 1));
+            break;
+        }
+    }
+
+    timer.slot = slot;
+    timer.previous = NIL;
+    timer.next = heads[slot];
+    if (heads[slot] != NIL) {
+        timers[heads[slot]].previous = index;
+    }
+    heads[slot] = index;
+}
+
+void ReminderScheduler::unlink(std::uint32_t index) {
+    Timer& timer = timers[index];
+    if (timer.previous != NIL) {
+        timers[timer.previous].next = timer.next;
+    }
+    else {
+        heads[timer.slot] = timer.next;
+    }
+    if (timer.next != NIL) {
+        timers[timer.next].previous = timer.previous;
+    }
+    timer.previous = NIL;
+    timer.next = NIL;
+}
+
+void ReminderScheduler::release(std::uint32_t index) {
+    Timer& timer = timers[index];
+    timer.event.reset();
+    timer.callback = nullptr;
+    timer.slot = FREE_SLOT;
+    ++timer.generation;
+    timer.next = freeList;
+    freeList = index;
+    --pending;
+}
+
+void ReminderScheduler::cascade(int slot) {
+    std::uint32_t index = heads[slot];
+    heads[slot] = NIL;
+
+    while (index != NIL) {
+        std::uint32_t next = timers[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+Timestamp ReminderScheduler::nextBusyTick(Timestamp tick) const {
+    // Slots that fall due at `tick` itself: the level-0 slot, plus any slot cascading at this boundary
+    for (int level = 0; level <= LEVELS; ++level) {
+        int shift = WHEEL_BITS * level;
+        if ((tick & ((Timestamp(1) << shift) - 1)) != 0) {
+            break;
+        }
+        int slot = level == LEVELS ? OVERFLOW_SLOT
+                                   : level * WHEEL_SIZE + static_cast<int>((tick >> shift) & (WHEEL_SIZE - 1));
+        if (heads[slot] != NIL) {
+            return tick;
+        }
+    }
+
+    // Otherwise the earliest later slot; lower levels always come due before higher ones
+    for (int level = 0; level < LEVELS; ++level) {
+        int shift = WHEEL_BITS * level;
+        int current = static_cast<int>((tick >> shift) & (WHEEL_SIZE - 1));
+        for (int slot = current + 1; slot < WHEEL_SIZE; ++slot) {
+            if (heads[level * WHEEL_SIZE + slot] != NIL) {
+                int periodShift = shift + WHEEL_BITS;
+                return ((tick >> periodShift) << periodShift) + (Timestamp(slot) << shift);
+            }
+        }
+    }
+
+    if (heads[OVERFLOW_SLOT] != NIL) {
+        int shift = WHEEL_BITS * LEVELS;
+        return ((tick >> shift) + 1) << shift;
+    }
+    return std::numeric_limits<Timestamp>::max();
+}
+
+void ReminderScheduler::advance(Timestamp now, std::vector<Fired>& fired) {
+    while (currentTick <= now) {
+        Timestamp tick = pending == 0 ? std::numeric_limits<Timestamp>::max() : nextBusyTick(currentTick);
+        if (tick > now) {
+            currentTick = now + 1;
+            break;
+        }
+        currentTick = tick;
+
+        if ((tick & ((Timestamp(1) << (WHEEL_BITS * LEVELS)) - 1)) == 0) {
+            cascade(OVERFLOW_SLOT);
+        }
+        for (int level = LEVELS - 1; level > 0; --level) {
+            int shift = WHEEL_BITS * level;
+            if ((tick & ((Timestamp(1) << shift) - 1)) == 0) {
+                cascade(level * WHEEL_SIZE + static_cast<int>((tick >> shift) & (WHEEL_SIZE - 1)));
+            }
+        }
+
+        int slot = static_cast<int>(tick & (WHEEL_SIZE - 1));
+        std::uint32_t index = heads[slot];
+        heads[slot] = NIL;
+
+        while (index != NIL) {
+            Timer& timer = timers[index];
+            std::uint32_t next = timer.next;
+            fired.push_back({ timer.event, std::move(timer.callback), timer.expires });
+            release(index);
+            index = next;
+        }
+
+        ++currentTick;
+    }
+}
+
+ReminderScheduler::TimerId ReminderScheduler::schedule(Timestamp when, std::shared_ptr<const Event> event, Callback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::uint32_t index = allocateTimer();
+    Timer& timer = timers[index];
+    timer.expires = when;
+    timer.event = std::move(event);
+    timer.callback = std::move(callback);
+    link(index);
+    ++pending;
+
+    return (static_cast<TimerId>(timer.generation) << 32) | index;
+}
+
+ReminderScheduler::TimerId ReminderScheduler::schedule(std::shared_ptr<const Event> event, Callback callback, int leadSeconds) {
+    Timestamp when = toTimestamp(event->getDate(), event->getTime().value_or(Time())) - leadSeconds;
+    return schedule(when, std::move(event), std::move(callback));
+}
+
+bool ReminderScheduler::cancel(TimerId id) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::uint32_t index = static_cast<std::uint32_t>(id & 0xFFFFFFFFu);
+    std::uint32_t generation = static_cast<std::uint32_t>(id >> 32);
+
+    if (index >= timers.size() || timers[index].generation != generation || timers[index].slot == FREE_SLOT) {
+        return false;
+    }
+
+    unlink(index);
+    release(index);
+    return true;
+}
+
+std::vector<ReminderScheduler::TimerId> ReminderScheduler::scheduleCalendar(const Calendar& calendar,
+    const Date& start, const Date& end, Callback callback, int leadSeconds) {
+    std::vector<TimerId> ids;
+
+    MergedEventCursor cursor = calendar.getMergedCursor(start, end);
+    while (cursor.hasNext()) {
+        std::shared_ptr<const Event> event = cursor.next();
+        if (event->hasTime()) {
+            ids.push_back(schedule(std::move(event), callback, leadSeconds));
+        }
+    }
+
+    return ids;
+}
+
+size_t ReminderScheduler::poll() {
+    std::vector<Fired> fired;
+    Timestamp reached;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        advance(clock->now(), fired);
+        reached = currentTick;
+    }
+
+    for (auto& item : fired) {
+        if (item.callback) {
+            item.callback(item.event, item.time);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        dispatchedTick = std::max(dispatchedTick, reached);
+    }
+    processed.notify_all();
+
+    return fired.size();
+}
+
+void ReminderScheduler::run() {
+    while (running) {
+        Timestamp now = clock->now();
+        poll();
+        if (running) {
+            clock->waitUntil(now + 1);
+        }
+    }
+}
+
+void ReminderScheduler::start() {
+    if (!running.exchange(true)) {
+        worker = std::thread(&ReminderScheduler::run, this);
+    }
+}
+
+void ReminderScheduler::stop() {
+    if (running.exchange(false)) {
+        clock->wake();
+        worker.join();
+        processed.notify_all();
+    }
+}
+
+void ReminderScheduler::sync() {
+    std::unique_lock<std::mutex> lock(mutex);
+    processed.wait(lock, [this] { return !running || dispatchedTick > clock->now(); });
+}
+
+size_t ReminderScheduler::pendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending;
+}
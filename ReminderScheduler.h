@@ -0,0 +1,143 @@
+#ifndef REMINDER_SCHEDULER_H
+#define REMINDER_SCHEDULER_H
+
+#include "Calendar.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Seconds on the calendar time line: Date::toSerial() * 86400 + time of day
+using Timestamp = long long;
+
+Timestamp toTimestamp(const Date& date, const Time& time = Time());
+
+class Clock {
+public:
+    virtual ~Clock() = default;
+
+    virtual Timestamp now() const = 0;
+    // Blocks until now() >= deadline or wake() is called
+    virtual void waitUntil(Timestamp deadline) = 0;
+    virtual void wake() = 0;
+};
+
+// Wall clock in local time
+class SystemClock : public Clock {
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool woken = false;
+
+public:
+    Timestamp now() const override;
+    void waitUntil(Timestamp deadline) override;
+    void wake() override;
+};
+
+// Manually advanced clock for simulations and tests
+class VirtualClock : public Clock {
+private:
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    Timestamp current;
+    bool woken = false;
+
+public:
+    explicit VirtualClock(Timestamp start = 0);
+
+    void advanceTo(Timestamp time);
+    void advanceBy(long long seconds);
+
+    Timestamp now() const override;
+    void waitUntil(Timestamp deadline) override;
+    void wake() override;
+};
+
+// Hierarchical timing wheel with one-second ticks. Insert and cancel are O(1); advancing
+// skips straight past empty slots, so idle stretches cost nothing per elapsed second.
+// Callbacks run on the worker thread (start()) or on the caller of poll().
+class ReminderScheduler {
+public:
+    using TimerId = std::uint64_t;
+    using Callback = std::function<void(const std::shared_ptr<const Event>&, Timestamp)>;
+
+private:
+    static constexpr int WHEEL_BITS = 6;
+    static constexpr int WHEEL_SIZE = 1 << WHEEL_BITS;
+    static constexpr int LEVELS = 5;
+    static constexpr std::uint32_t NIL = 0xFFFFFFFFu;
+    static constexpr int OVERFLOW_SLOT = LEVELS * WHEEL_SIZE;
+    static constexpr int FREE_SLOT = -1;
+
+    struct Timer {
+        Timestamp expires = 0;
+        std::shared_ptr<const Event> event;
+        Callback callback;
+        std::uint32_t previous = NIL;
+        std::uint32_t next = NIL;
+        std::uint32_t generation = 1;
+        int slot = FREE_SLOT;
+    };
+
+    struct Fired {
+        std::shared_ptr<const Event> event;
+        Callback callback;
+        Timestamp time;
+    };
+
+    std::shared_ptr<Clock> clock;
+
+    mutable std::mutex mutex;
+    std::condition_variable processed;
+    std::vector<Timer> timers;
+    std::uint32_t freeList = NIL;
+    std::uint32_t heads[OVERFLOW_SLOT + 1];
+    Timestamp currentTick;
+    Timestamp dispatchedTick;
+    size_t pending = 0;
+
+    std::thread worker;
+    std::atomic<bool> running{ false };
+
+    std::uint32_t allocateTimer();
+    void link(std::uint32_t index);
+    void unlink(std::uint32_t index);
+    void release(std::uint32_t index);
+    void cascade(int slot);
+    // First tick at or after `tick` that fires a slot or cascades a non-empty one
+    Timestamp nextBusyTick(Timestamp tick) const;
+    void advance(Timestamp now, std::vector<Fired>& fired);
+    void run();
+
+public:
+    explicit ReminderScheduler(std::shared_ptr<Clock> clock = std::make_shared<SystemClock>());
+    ~ReminderScheduler();
+
+    ReminderScheduler(const ReminderScheduler&) = delete;
+    ReminderScheduler& operator=(const ReminderScheduler&) = delete;
+
+    TimerId schedule(Timestamp when, std::shared_ptr<const Event> event, Callback callback);
+    TimerId schedule(std::shared_ptr<const Event> event, Callback callback, int leadSeconds = 0);
+    bool cancel(TimerId id);
+
+    // Schedules every timed event of the calendar within [start, end], recurring occurrences included
+    std::vector<TimerId> scheduleCalendar(const Calendar& calendar, const Date& start, const Date& end,
+        Callback callback, int leadSeconds = 0);
+
+    void start();
+    void stop();
+
+    // Fires everything due up to the clock's current time on the calling thread
+    size_t poll();
+    // Waits until the worker has caught up with the clock
+    void sync();
+
+    size_t pendingCount() const;
+};
+
+#endif // REMINDER_SCHEDULER_H
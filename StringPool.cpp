@@ -0,0 +1,102 @@
+#include "StringPool.h"
+#include <algorithm>
+#include <atomic>
+
+// All empty strings share one entry
+const std::shared_ptr<const InternedString::Entry>& InternedString::emptyEntry() {
+    static const std::shared_ptr<const Entry> empty = std::make_shared<const Entry>(std::string(), 0);
+    return empty;
+}
+
+InternedString::InternedString() : entry(emptyEntry()) {}
+
+InternedString::InternedString(std::string text)
+    : entry(text.empty() ? emptyEntry() : std::make_shared<const Entry>(std::move(text), 0)) {}
+
+bool InternedString::operator==(const InternedString& other) const {
+    if (entry == other.entry) {
+        return true;
+    }
+    // A pool never holds two entries with the same text
+    std::uint64_t pool = entry->pool.load(std::memory_order_relaxed);
+    if (pool != 0 && pool == other.entry->pool.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    return entry->text == other.entry->text;
+}
+
+std::uint64_t StringPool::nextId() {
+    static std::atomic<std::uint64_t> counter{ 0 };
+    return ++counter;
+}
+
+StringPool::StringPool() : id(nextId()) {}
+
+// A copy must not share the id: both pools may later intern the same new text separately
+StringPool::StringPool(const StringPool& other)
+    : entries(other.entries), id(nextId()), sweepThreshold(other.sweepThreshold) {}
+
+StringPool& StringPool::operator=(const StringPool& other) {
+    if (this != &other) {
+        entries = other.entries;
+        id = nextId();
+        sweepThreshold = other.sweepThreshold;
+    }
+    return *this;
+}
+
+InternedString StringPool::intern(std::string_view text) {
+    if (text.empty()) {
+        return InternedString();
+    }
+
+    auto it = entries.find(text);
+    if (it != entries.end()) {
+        return it->second;
+    }
+    return insert(InternedString(std::make_shared<const InternedString::Entry>(std::string(text), id)));
+}
+
+InternedString StringPool::intern(const InternedString& text) {
+    std::uint64_t owner = text.entry->pool.load(std::memory_order_relaxed);
+    if (owner == id) {
+        return text;
+    }
+    if (text.empty()) {
+        return InternedString();
+    }
+
+    auto it = entries.find(text.str());
+    if (it != entries.end()) {
+        return it->second;
+    }
+
+    if (owner == 0 && text.entry->pool.compare_exchange_strong(owner, id)) {
+        return insert(text);
+    }
+    return insert(InternedString(std::make_shared<const InternedString::Entry>(text.str(), id)));
+}
+
+InternedString StringPool::insert(InternedString handle) {
+    if (entries.size() >= sweepThreshold) {
+        sweep();
+        sweepThreshold = std::max<size_t>(1024, entries.size() * 2);
+    }
+
+    entries.emplace(std::string_view(handle.str()), handle);
+    return handle;
+}
+
+size_t StringPool::sweep() {
+    size_t removed = 0;
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.entry.use_count() == 1) {
+            it = entries.erase(it);
+            ++removed;
+        }
+        else {
+            ++it;
+        }
+    }
+    return removed;
+}
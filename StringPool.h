@@ -0,0 +1,73 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Shared immutable string. Copies share one allocation; handles interned by the same
+// pool compare by pointer alone.
+class InternedString {
+private:
+    struct Entry {
+        std::string text;
+        mutable std::atomic<std::uint64_t> pool;   // 0 = not interned yet
+
+        Entry(std::string text, std::uint64_t pool) : text(std::move(text)), pool(pool) {}
+    };
+
+    std::shared_ptr<const Entry> entry;
+
+    explicit InternedString(std::shared_ptr<const Entry> entry) : entry(std::move(entry)) {}
+
+    static const std::shared_ptr<const Entry>& emptyEntry();
+
+    friend class StringPool;
+
+public:
+    InternedString();
+    explicit InternedString(std::string text);
+
+    const std::string& str() const { return entry->text; }
+    size_t size() const { return entry->text.size(); }
+    bool empty() const { return entry->text.empty(); }
+
+    bool operator==(const InternedString& other) const;
+    bool operator!=(const InternedString& other) const { return !(*this == other); }
+
+    friend std::ostream& operator<<(std::ostream& os, const InternedString& text) {
+        return os << text.str();
+    }
+};
+
+// Deduplicates strings: interning equal text twice yields handles to the same entry.
+// Entries are reference counted, so handles stay valid after the pool is gone.
+class StringPool {
+private:
+    std::unordered_map<std::string_view, InternedString> entries;   // keys view the entry text
+    std::uint64_t id;
+    size_t sweepThreshold = 1024;
+
+    static std::uint64_t nextId();
+    InternedString insert(InternedString handle);
+
+public:
+    StringPool();
+    StringPool(const StringPool& other);
+    StringPool& operator=(const StringPool& other);
+
+    InternedString intern(std::string_view text);
+    // Adopts the handle's own entry when it is not interned anywhere yet, so text
+    // moved into an Event is never copied again
+    InternedString intern(const InternedString& text);
+
+    // Drops entries no longer referenced outside the pool; runs on its own as the pool grows
+    size_t sweep();
+    size_t size() const { return entries.size(); }
+};
+
+#endif // STRING_POOL_H
@@ -0,0 +1,146 @@
+#include "TitleIndex.h"
+#include <algorithm>
+#include <cctype>
+
+TitleIndex::TitleIndex(size_t capacity) : nodes(1), capacity(capacity > 0 ? capacity : 1) {}
+
+// Keys are lowercased while walking, so lookups never build a normalized copy
+char TitleIndex::fold(char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+std::uint32_t TitleIndex::findChild(std::uint32_t node, char label) const {
+    const auto& children = nodes[node].children;
+    auto it = std::lower_bound(children.begin(), children.end(), label,
+        [](const std::pair<char, std::uint32_t>& child, char value) { return child.first < value; });
+    return it != children.end() && it->first == label ? it->second : NIL;
+}
+
+std::uint32_t TitleIndex::addChild(std::uint32_t node, char label) {
+    std::uint32_t child;
+    if (!freeNodes.empty()) {
+        child = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[child] = Node();
+    }
+    else {
+        child = static_cast<std::uint32_t>(nodes.size());
+        nodes.emplace_back();
+    }
+    nodes[child].parent = node;
+    nodes[child].label = label;
+
+    auto& children = nodes[node].children;
+    auto it = std::lower_bound(children.begin(), children.end(), label,
+        [](const std::pair<char, std::uint32_t>& entry, char value) { return entry.first < value; });
+    children.insert(it, { label, child });
+    return child;
+}
+
+std::uint32_t TitleIndex::find(std::string_view title) const {
+    std::uint32_t node = 0;
+    for (char c : title) {
+        node = findChild(node, fold(c));
+        if (node == NIL) {
+            return NIL;
+        }
+    }
+    return node;
+}
+
+bool TitleIndex::ranksBefore(std::uint32_t a, std::uint32_t b) const {
+    if (nodes[a].frequency != nodes[b].frequency) {
+        return nodes[a].frequency > nodes[b].frequency;
+    }
+    return displayTitles.at(a) < displayTitles.at(b);
+}
+
+void TitleIndex::refreshPath(std::uint32_t node) {
+    while (node != NIL) {
+        Node& current = nodes[node];
+
+        std::vector<std::uint32_t> candidates;
+        if (current.frequency > 0) {
+            candidates.push_back(node);
+        }
+        for (const auto& child : current.children) {
+            const auto& childTop = nodes[child.second].top;
+            candidates.insert(candidates.end(), childTop.begin(), childTop.end());
+        }
+
+        size_t keep = std::min(capacity, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(),
+            [this](std::uint32_t a, std::uint32_t b) { return ranksBefore(a, b); });
+        candidates.resize(keep);
+        nodes[node].top = std::move(candidates);
+
+        node = nodes[node].parent;
+    }
+}
+
+std::uint32_t TitleIndex::prune(std::uint32_t node) {
+    while (node != 0 && nodes[node].frequency == 0 && nodes[node].children.empty()) {
+        std::uint32_t parent = nodes[node].parent;
+        auto& siblings = nodes[parent].children;
+        siblings.erase(std::find_if(siblings.begin(), siblings.end(),
+            [node](const std::pair<char, std::uint32_t>& child) { return child.second == node; }));
+
+        nodes[node] = Node();
+        freeNodes.push_back(node);
+        node = parent;
+    }
+    return node;
+}
+
+void TitleIndex::add(std::string_view title) {
+    std::uint32_t node = 0;
+    for (char c : title) {
+        char label = fold(c);
+        std::uint32_t child = findChild(node, label);
+        node = child != NIL ? child : addChild(node, label);
+    }
+
+    if (nodes[node].frequency++ == 0) {
+        displayTitles[node] = std::string(title);
+    }
+    refreshPath(node);
+}
+
+void TitleIndex::remove(std::string_view title) {
+    std::uint32_t node = find(title);
+    if (node == NIL || nodes[node].frequency == 0) {
+        return;
+    }
+
+    if (--nodes[node].frequency == 0) {
+        displayTitles.erase(node);
+    }
+    refreshPath(prune(node));
+}
+
+void TitleIndex::clear() {
+    nodes.assign(1, Node());
+    freeNodes.clear();
+    displayTitles.clear();
+}
+
+std::vector<std::string> TitleIndex::complete(std::string_view prefix, size_t count) const {
+    std::vector<std::string> result;
+    std::uint32_t node = find(prefix);
+    if (node == NIL) {
+        return result;
+    }
+
+    const auto& top = nodes[node].top;
+    size_t limit = std::min(count, top.size());
+    result.reserve(limit);
+    for (size_t i = 0; i < limit; ++i) {
+        result.push_back(displayTitles.at(top[i]));
+    }
+    return result;
+}
+
+size_t TitleIndex::frequency(std::string_view title) const {
+    std::uint32_t node = find(title);
+    return node == NIL ? 0 : nodes[node].frequency;
+}
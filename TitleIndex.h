@@ -0,0 +1,50 @@
+#ifndef TITLE_INDEX_H
+#define TITLE_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Case-insensitive trie over event titles. Every node caches its `capacity`
+// most frequent completions, so a lookup costs O(prefix length + count).
+class TitleIndex {
+private:
+    static constexpr std::uint32_t NIL = 0xFFFFFFFFu;
+
+    struct Node {
+        std::vector<std::pair<char, std::uint32_t>> children;
+        std::vector<std::uint32_t> top;
+        std::uint32_t parent = NIL;
+        std::uint32_t frequency = 0;
+        char label = 0;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<std::uint32_t> freeNodes;
+    std::unordered_map<std::uint32_t, std::string> displayTitles;
+    size_t capacity;
+
+    static char fold(char c);
+    std::uint32_t findChild(std::uint32_t node, char label) const;
+    std::uint32_t addChild(std::uint32_t node, char label);
+    std::uint32_t find(std::string_view title) const;
+    bool ranksBefore(std::uint32_t a, std::uint32_t b) const;
+    void refreshPath(std::uint32_t node);
+    std::uint32_t prune(std::uint32_t node);
+
+public:
+    explicit TitleIndex(size_t capacity = 10);
+
+    void add(std::string_view title);
+    void remove(std::string_view title);
+    void clear();
+
+    // Most frequent titles starting with `prefix`; at most `capacity` results
+    std::vector<std::string> complete(std::string_view prefix, size_t count) const;
+    size_t frequency(std::string_view title) const;
+};
+
+#endif // TITLE_INDEX_H
@@ -0,0 +1,14 @@
+#include "WordNormalizer.h"
+#include <algorithm>
+#include <cctype>
+
+std::string normalizeWord(std::string word) {
+    word.erase(std::remove_if(word.begin(), word.end(),
+        [](char c) { return std::ispunct(static_cast<unsigned char>(c)); }),
+        word.end());
+
+    std::transform(word.begin(), word.end(), word.begin(),
+        [](unsigned char c) { return std::tolower(c); });
+
+    return word;
+}
@@ -0,0 +1,9 @@
+#ifndef WORD_NORMALIZER_H
+#define WORD_NORMALIZER_H
+
+#include <string>
+
+// Strips punctuation and lowercases, as used when building a dictionary or a text index
+std::string normalizeWord(std::string word);
+
+#endif // WORD_NORMALIZER_H
@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Calendar.h"
+#include "EventGenerator.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    size_t peakMemoryBytes() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return counters.PeakWorkingSetSize;
+        }
+        return 0;
+#else
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return static_cast<size_t>(usage.ru_maxrss);
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
+    struct Measurement {
+        std::string name;
+        std::vector<double> latencies;
+        double totalSeconds = 0;
+    };
+
+    double percentile(std::vector<double>& sorted, double quantile) {
+        if (sorted.empty()) {
+            return 0;
+        }
+        size_t index = static_cast<size_t>(quantile * static_cast<double>(sorted.size() - 1));
+        return sorted[index];
+    }
+
+    template <typename Operation>
+    Measurement measure(const std::string& name, size_t iterations, Operation operation) {
+        Measurement result;
+        result.name = name;
+        result.latencies.reserve(iterations);
+
+        Clock::time_point begin = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            Clock::time_point start = Clock::now();
+            operation(i);
+            result.latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        }
+        result.totalSeconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+        return result;
+    }
+
+    void report(Measurement& measurement) {
+        std::sort(measurement.latencies.begin(), measurement.latencies.end());
+        double throughput = measurement.totalSeconds > 0 ? measurement.latencies.size() / measurement.totalSeconds : 0;
+
+        std::cout << std::left << std::setw(24) << measurement.name << std::right
+            << std::setw(10) << measurement.latencies.size()
+            << std::setw(14) << std::fixed << std::setprecision(0) << throughput
+            << std::setw(12) << std::setprecision(2) << percentile(measurement.latencies, 0.5)
+            << std::setw(12) << percentile(measurement.latencies, 0.9)
+            << std::setw(12) << percentile(measurement.latencies, 0.99)
+            << std::setw(12) << (measurement.latencies.empty() ? 0.0 : measurement.latencies.back())
+            << std::endl;
+    }
+
+    std::vector<size_t> parseSizes(const std::string& text) {
+        std::vector<size_t> sizes;
+        std::istringstream iss(text);
+        std::string item;
+        while (std::getline(iss, item, ',')) {
+            if (!item.empty()) {
+                sizes.push_back(static_cast<size_t>(std::stod(item)));
+            }
+        }
+        return sizes;
+    }
+
+    void runBenchmark(size_t size, std::uint64_t seed, bool columnar, size_t cacheBudget) {
+        EventGenerator generator(seed);
+        std::vector<Event> events = generator.generate(size);
+
+        // Scanning queries are O(n); keep each size within a few seconds
+        size_t queries = std::max<size_t>(5, std::min<size_t>(1000, 20000000 / std::max<size_t>(size, 1)));
+        EventGenerator probes(seed + 1);
+        std::vector<Event> probeEvents = probes.generate(queries);
+
+        std::cout << "\n===== " << size << " events, seed " << seed << ", " << queries << " queries per operation"
+            << (columnar ? ", columnar scans" : "") << (cacheBudget ? ", query cache" : "") << " =====\n";
+        std::cout << std::left << std::setw(24) << "operation" << std::right << std::setw(10) << "ops"
+            << std::setw(14) << "ops/s" << std::setw(12) << "p50 us" << std::setw(12) << "p90 us"
+            << std::setw(12) << "p99 us" << std::setw(12) << "max us" << std::endl;
+
+        Calendar calendar(generator.getFirstDay());
+        calendar.setColumnarScans(columnar);
+        calendar.setQueryCacheBudget(cacheBudget);
+        size_t sink = 0;
+
+        Measurement add = measure("addEvent", events.size(), [&](size_t i) {
+            calendar.addEvent(events[i]);
+            });
+        report(add);
+
+        Measurement day = measure("getEventsForDay", queries, [&](size_t i) {
+            sink += calendar.getEventsForDay(probeEvents[i].getDate()).size();
+            });
+        report(day);
+
+        Measurement month = measure("getEventsForMonth", queries, [&](size_t i) {
+            const Date& date = probeEvents[i].getDate();
+            sink += calendar.getEventsForMonth(date.getMonth(), date.getYear()).size();
+            });
+        report(month);
+
+        Measurement range = measure("getEventsInDateRange", queries, [&](size_t i) {
+            const Date& date = probeEvents[i].getDate();
+            sink += calendar.getEventsInDateRange(date, date + 6).size();
+            });
+        report(range);
+
+        Measurement type = measure("getEventsByType", queries, [&](size_t i) {
+            sink += calendar.getEventsByType(probeEvents[i].getType()).size();
+            });
+        report(type);
+
+        Measurement priority = measure("getEventsByPriority", queries, [&](size_t i) {
+            sink += calendar.getEventsByPriority(probeEvents[i].getPriority()).size();
+            });
+        report(priority);
+
+        Measurement displayMonth = measure("displayMonth", queries, [&](size_t i) {
+            calendar.setCurrentDate(probeEvents[i].getDate());
+            sink += calendar.displayMonth().size();
+            });
+        report(displayMonth);
+
+        Measurement displayYear = measure("displayYear", std::min<size_t>(queries, 100), [&](size_t i) {
+            calendar.setCurrentDate(probeEvents[i].getDate());
+            sink += calendar.displayYear().size();
+            });
+        report(displayYear);
+
+        Measurement remove = measure("removeEvent", std::min(queries, events.size()), [&](size_t i) {
+            calendar.removeEvent(events[(i * 7919) % events.size()]);
+            });
+        report(remove);
+
+        if (cacheBudget) {
+            QueryCache::Stats cache = calendar.getQueryCacheStats();
+            std::cout << "query cache: " << cache.hits << " hits, " << cache.misses << " misses, "
+                << cache.invalidations << " invalidated, " << cache.evictions << " evicted, "
+                << cache.bytes / 1024 << " KiB held" << std::endl;
+        }
+        std::cout << "peak memory: " << peakMemoryBytes() / (1024 * 1024) << " MiB (process lifetime)"
+            << "  [checksum " << sink << "]" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = { 1000, 10000, 100000 };
+    std::uint64_t seed = 42;
+    bool printMetrics = false;
+    bool columnar = false;
+    size_t cacheBudget = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--sizes" && i + 1 < argc) {
+            sizes = parseSizes(argv[++i]);
+        }
+        else if (argument == "--seed" && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (argument == "--metrics") {
+            printMetrics = true;
+        }
+        else if (argument == "--columnar") {
+            columnar = true;
+        }
+        else if (argument == "--cache" && i + 1 < argc) {
+            cacheBudget = static_cast<size_t>(std::strtod(argv[++i], nullptr));
+        }
+        else {
+            std::cout << "usage: benchmark [--sizes 1e3,1e4,...] [--seed N] [--metrics] [--columnar] [--cache BYTES]" << std::endl;
+            return argument == "--help" ? 0 : 1;
+        }
+    }
+
+    for (size_t size : sizes) {
+        runBenchmark(size, seed, columnar, cacheBudget);
+    }
+
+    if (printMetrics) {
+        std::cout << "\n" << CalendarMetrics::toText();
+    }
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include "CalendarServer.h"
+#include "EventFormats.h"
+#include <csignal>
+#include <iostream>
+#include <string>
+
+namespace {
+
+CalendarServer* activeServer = nullptr;
+
+void handleSignal(int) {
+    if (activeServer != nullptr) {
+        activeServer->stop();
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || std::string(argv[1]) == "--help") {
+        std::cout << "usage: calendar_server SOCKET [--ics FILE] [--csv FILE]" << std::endl;
+        return argc < 2 ? 1 : 0;
+    }
+
+    Calendar calendar;
+    try {
+        for (int i = 2; i < argc; ++i) {
+            std::string argument = argv[i];
+            if (argument == "--ics" && i + 1 < argc) {
+                std::cout << "imported " << importIcs(calendar, argv[++i]) << " events" << std::endl;
+            }
+            else if (argument == "--csv" && i + 1 < argc) {
+                std::cout << "imported " << importCsv(calendar, argv[++i]) << " events" << std::endl;
+            }
+            else {
+                std::cerr << "unknown argument: " << argument << std::endl;
+                return 1;
+            }
+        }
+
+        CalendarServer server(calendar, argv[1]);
+        activeServer = &server;
+        std::signal(SIGINT, handleSignal);
+        std::signal(SIGTERM, handleSignal);
+
+        std::cout << "listening on " << server.getPath() << std::endl;
+        server.run();
+        activeServer = nullptr;
+
+        const CalendarServer::Stats& stats = server.getStats();
+        std::cout << stats.connections << " connections, " << stats.requests << " requests, "
+            << stats.errors << " errors, " << stats.writes << " writes" << std::endl;
+    }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
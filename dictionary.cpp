@@ -1,5 +1,6 @@
 #include "screen.h"
 #include"dictionary.h"
+#include "WordNormalizer.h"
 #include <stdexcept>
 #include <algorithm>
 #include <iostream>
@@ -13,12 +14,7 @@ Dictionary::Dictionary(const std::string& filename) {
 
 	std::string word;
 	while (file >> word) {
-		word.erase(std::remove_if(word.begin(), word.end(),
-			[](char c) { return std::ispunct(static_cast<unsigned char>(c)); }),
-			word.end());
-
-		std::transform(word.begin(), word.end(), word.begin(),
-			[](unsigned char c) { return std::tolower(c); });
+		word = normalizeWord(std::move(word));
 
 		if (!word.empty()) {
 			wordFrequency[word]++;
@@ -30,17 +26,24 @@ Dictionary::Dictionary(const std::string& filename) {
 
 
 Dictionary::Dictionary(const Screen& screen) {
-	for (const auto& paragraph : screen.getText()) {
-		std::istringstream iss(paragraph);
-		std::string word;
-		while (iss >> word) {
-			word.erase(std::remove_if(word.begin(), word.end(),
-				[](char c) { return std::ispunct(static_cast<unsigned char>(c)); }),
-				word.end());
-
-			std::transform(word.begin(), word.end(), word.begin(),
-				[](unsigned char c) { return std::tolower(c); });
+	for (ParagraphCursor cursor = screen.getParagraphs(); cursor.hasNext();) {
+		// Same words as reading the paragraph with >>; a mapped paragraph's line breaks are whitespace too
+		std::string_view text = cursor.next().bytes();
+		size_t end = 0;
+		while (true) {
+			size_t start = end;
+			while (start < text.size() && std::isspace(static_cast<unsigned char>(text[start]))) {
+				++start;
+			}
+			if (start == text.size()) {
+				break;
+			}
+			end = start;
+			while (end < text.size() && !std::isspace(static_cast<unsigned char>(text[end]))) {
+				++end;
+			}
 
+			std::string word = normalizeWord(std::string(text.substr(start, end - start)));
 			if (!word.empty()) {
 				wordFrequency[word]++;
 			}
@@ -10,7 +10,7 @@
 #include <algorithm>
 #include <iostream>
 #include <functional>
-#include "Screen.h"
+#include "screen.h"
 
 enum class WordStatus {
     New,
@@ -10,6 +10,12 @@
 #include "screen.h"
 #include "dictionary.h"
 #include "deque.h"
+#include "ReminderScheduler.h"
+#ifdef __linux__
+#include <thread>
+#include "CalendarServer.h"
+#include "CalendarClient.h"
+#endif
 
 
 void testDateAndTime() {
@@ -350,6 +356,85 @@ void evalDequeComposition() {
     std::cout << "4. It allows for easier runtime switching of implementation strategies" << std::endl;
 }
 
+void evalCalendarService() {
+    std::cout << "\n*************** SECTION 11: Calendar Query Service ***************\n" << std::endl;
+
+#ifdef __linux__
+    Calendar calendar(Date(25, 4, 2025));
+    calendar.addEvent(Event(Date(27, 4, 2025), Time(10, 0, 0), "Team Meeting",
+        EventType::MEETING, EventPriority::HIGH));
+
+    RecurrenceRule weekly(RecurrenceFrequency::WEEKLY);
+    weekly.setCount(3);
+    calendar.addRecurringEvent(Event(Date(28, 4, 2025), Time(9, 30, 0), "Stand-up", EventType::MEETING), weekly);
+
+    try {
+        CalendarServer server(calendar, "/tmp/lotariev_calendar.sock");
+        std::thread serving([&server] { server.run(); });
+
+        try {
+            CalendarClient client(server.getPath());
+
+            std::cout << ">> Adding an event through the client" << std::endl;
+            client.addEvent(Event(Date(30, 4, 2025), Time(23, 59, 59), "Project Deadline",
+                EventType::DEADLINE, EventPriority::URGENT));
+
+            std::cout << ">> Events from 25.04.2025 to 31.05.2025:" << std::endl;
+            for (const Event& event : client.getEventsInDateRange(Date(25, 4, 2025), Date(31, 5, 2025))) {
+                std::cout << "- " << event.getTitle() << " on " << event.getDate() << std::endl;
+            }
+
+            std::cout << ">> Removing the meeting: " << client.removeEvent(Event(Date(27, 4, 2025), Time(10, 0, 0), ""))
+                << " event(s) removed" << std::endl;
+            std::cout << ">> Urgent events: " << client.getEventsByPriority(EventPriority::URGENT).size() << std::endl;
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Exception caught: " << e.what() << std::endl;
+        }
+
+        server.stop();
+        serving.join();
+        std::cout << "Server handled " << server.getStats().requests << " requests" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+    }
+#else
+    std::cout << "The query service runs on Linux only (epoll and Unix domain sockets)." << std::endl;
+#endif
+}
+
+void evalReminders() {
+    std::cout << "\n*************** SECTION 12: Reminders on a Virtual Clock ***************\n" << std::endl;
+
+    Calendar calendar(Date(25, 4, 2025));
+    calendar.addEvent(Event(Date(27, 4, 2025), Time(10, 0, 0), "Team Meeting",
+        EventType::MEETING, EventPriority::HIGH));
+    calendar.addEvent(Event(Date(30, 4, 2025), Time(23, 59, 59), "Project Deadline",
+        EventType::DEADLINE, EventPriority::URGENT));
+    calendar.addEvent(Event(Date(15, 5, 2025), "Birthday", EventType::CELEBRATION, EventPriority::MEDIUM));
+
+    RecurrenceRule weekly(RecurrenceFrequency::WEEKLY);
+    weekly.setCount(3);
+    calendar.addRecurringEvent(Event(Date(28, 4, 2025), Time(9, 30, 0), "Stand-up", EventType::MEETING), weekly);
+
+    // Nothing waits for real time: the clock only moves when the demo advances it
+    auto clock = std::make_shared<VirtualClock>(toTimestamp(Date(25, 4, 2025)));
+    ReminderScheduler scheduler(clock);
+    scheduler.scheduleCalendar(calendar, Date(25, 4, 2025), Date(31, 5, 2025),
+        [](const std::shared_ptr<const Event>& event, Timestamp) {
+            std::cout << "Reminder: " << event->getTitle() << " on " << event->getDate()
+                << " at " << *event->getTime() << std::endl;
+        }, 15 * 60);
+    std::cout << "Reminders scheduled (timed events only, 15 minutes ahead): " << scheduler.pendingCount() << std::endl;
+
+    for (int day = 1; day <= 21; ++day) {
+        clock->advanceBy(24 * 60 * 60);
+        scheduler.poll();
+    }
+    std::cout << "Reminders left after three weeks: " << scheduler.pendingCount() << std::endl;
+}
+
 int main() {
     testCalendar();
     testDateAndTime();
@@ -360,6 +445,8 @@ int main() {
     evalDictionaryFunctionality();
     evalDequeNVI();
     evalDequeComposition();
+    evalCalendarService();
+    evalReminders();
 
     return 0;
 }
\ No newline at end of file
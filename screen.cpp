@@ -1,10 +1,22 @@
 #include "screen.h"
+#include "MappedFile.h"
+#include "ParagraphPager.h"
+#include "ParagraphScanner.h"
 #include <stdexcept>
 #include <algorithm>
 #include <iostream>
 #include <sstream>
 
-Screen::Screen(const std::string& filename) {
+Screen::Screen(const std::string& filename, ScreenLoading loading) {
+    if (loading == ScreenLoading::MAPPED) {
+        mapParagraphs(filename);
+        return;
+    }
+    if (loading == ScreenLoading::PAGED) {
+        text = ParagraphRope(std::make_shared<ParagraphPager>(filename));
+        return;
+    }
+
     std::ifstream file(filename);
     if (!file.is_open()) {
         throw std::runtime_error("Cannot open file: " + filename);
@@ -12,10 +24,15 @@ Screen::Screen(const std::string& filename) {
 
     std::string line;
     std::string paragraph;
+    std::vector<Paragraph> paragraphs;
 
     while (std::getline(file, line)) {
+        // Text mode strips "\r\n" on Windows only; the mapped and paged loaders strip it everywhere
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
         if (line.empty() && !paragraph.empty()) {
-            text.push_back(paragraph);
+            paragraphs.push_back(paragraph);
             paragraph.clear();
         }
         else if (!line.empty()) {
@@ -27,14 +44,37 @@ Screen::Screen(const std::string& filename) {
     }
 
     if (!paragraph.empty()) {
-        text.push_back(paragraph);
+        paragraphs.push_back(paragraph);
     }
 
     file.close();
+    text = ParagraphRope(std::move(paragraphs));
+}
+
+// Same paragraphs as the stream loader: runs of non-empty lines separated by empty ones.
+// A paragraph's bytes run from its first line to the end of its last, so the line breaks
+// inside it are exactly the single spaces the stream loader joins lines with.
+void Screen::mapParagraphs(const std::string& filename) {
+    try {
+        file = std::make_shared<const MappedFile>(filename);
+    }
+    catch (const std::runtime_error&) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+
+    std::vector<ParagraphSpan> spans = ParagraphScanner::scan(file->view());
+    std::vector<Paragraph> paragraphs;
+    paragraphs.reserve(spans.size());
+    for (const ParagraphSpan& span : spans) {
+        paragraphs.push_back(Paragraph::view(file->view().substr(static_cast<size_t>(span.offset), static_cast<size_t>(span.length))));
+    }
+    text = ParagraphRope(std::move(paragraphs));
 }
 
 Screen::Screen(const Screen& other)
     : text(other.text),
+    history(other.history),
+    file(other.file),
     position(other.position),
     linesPerScreen(other.linesPerScreen) {
     std::cout << "Screen copy constructor invoked" << std::endl;
@@ -42,6 +82,8 @@ Screen::Screen(const Screen& other)
 
 Screen::Screen(Screen&& other) noexcept
     : text(std::move(other.text)),
+    history(std::move(other.history)),
+    file(std::move(other.file)),
     position(other.position),
     linesPerScreen(other.linesPerScreen) {
     other.position = 0;
@@ -51,6 +93,8 @@ Screen::Screen(Screen&& other) noexcept
 Screen& Screen::operator=(const Screen& other) {
     if (this != &other) {
         text = other.text;
+        history = other.history;
+        file = other.file;
         position = other.position;
         linesPerScreen = other.linesPerScreen;
     }
@@ -61,6 +105,8 @@ Screen& Screen::operator=(const Screen& other) {
 Screen& Screen::operator=(Screen&& other) noexcept {
     if (this != &other) {
         text = std::move(other.text);
+        history = std::move(other.history);
+        file = std::move(other.file);
         position = other.position;
         linesPerScreen = other.linesPerScreen;
         other.position = 0;
@@ -69,6 +115,15 @@ Screen& Screen::operator=(Screen&& other) noexcept {
     return *this;
 }
 
+std::vector<std::string> Screen::getText() const {
+    std::vector<std::string> result;
+    result.reserve(text.size());
+    for (ParagraphCursor cursor = text.getCursor(); cursor.hasNext();) {
+        result.push_back(cursor.next().str());
+    }
+    return result;
+}
+
 void Screen::scrollForward() {
     if (position + linesPerScreen < text.size()) {
         ++position;
@@ -82,28 +137,86 @@ void Screen::scrollBackward() {
 }
 
 void Screen::insertLine(const std::string& line) {
-    text.insert(text.begin() + position, line);
+    Edit edit;
+    edit.kind = EditKind::INSERT;
+    edit.index = position;
+    edit.after = Paragraph(line);
+    text.insert(position, edit.after);
+    history.record(std::move(edit));
 }
 
 void Screen::deleteLine() {
     if (position < text.size()) {
-        text.erase(text.begin() + position);
+        Edit edit;
+        edit.kind = EditKind::ERASE;
+        edit.index = position;
+        edit.before = text.at(position);
+        text.erase(position);
+        history.record(std::move(edit));
     }
 }
 
 void Screen::modifyLine(const std::string& newLine) {
     if (position < text.size()) {
-        text[position] = newLine;
+        Edit edit;
+        edit.kind = EditKind::REPLACE;
+        edit.index = position;
+        edit.before = text.at(position);
+        edit.after = Paragraph(newLine);
+        text.replace(position, edit.after);
+        history.record(std::move(edit));
+    }
+}
+
+bool Screen::undo() {
+    if (!history.canUndo()) {
+        return false;
+    }
+
+    const Edit& edit = history.takeUndo();
+    switch (edit.kind) {
+    case EditKind::INSERT:
+        text.erase(edit.index);
+        break;
+    case EditKind::ERASE:
+        text.insert(edit.index, edit.before);
+        break;
+    case EditKind::REPLACE:
+        text.replace(edit.index, edit.before);
+        break;
     }
+    position = edit.index;
+    return true;
+}
+
+bool Screen::redo() {
+    if (!history.canRedo()) {
+        return false;
+    }
+
+    const Edit& edit = history.takeRedo();
+    switch (edit.kind) {
+    case EditKind::INSERT:
+        text.insert(edit.index, edit.after);
+        break;
+    case EditKind::ERASE:
+        text.erase(edit.index);
+        break;
+    case EditKind::REPLACE:
+        text.replace(edit.index, edit.after);
+        break;
+    }
+    position = edit.index;
+    return true;
 }
 
 void Screen::display() const {
     std::cout << "--------------- Screen Content (position " << position << ") ---------------" << std::endl;
 
-    size_t endPosition = std::min(position + linesPerScreen, text.size());
-
-    for (size_t i = position; i < endPosition; ++i) {
-        std::cout << "[" << i - position << "] " << text[i] << std::endl;
+    ParagraphCursor cursor = text.getCursor(position);
+    while (cursor.hasNext() && cursor.getIndex() < position + linesPerScreen) {
+        size_t index = cursor.getIndex();
+        std::cout << "[" << index - position << "] " << cursor.next() << std::endl;
     }
 
     std::cout << "--------------- End of Screen ------------------" << std::endl;
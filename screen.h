@@ -10,21 +10,40 @@
 #include <algorithm>
 #include <iostream>
 #include <functional>
+#include <string_view>
+#include "EditHistory.h"
+#include "ParagraphRope.h"
+
+class MappedFile;
+
+enum class ScreenLoading {
+    STREAM,   // read line by line into paragraphs of their own
+    MAPPED,   // map the file; paragraphs stay views into it until edited
+    PAGED     // index the file; paragraphs are read on demand around the position
+};
 
 class Screen {
 private:
-    std::vector<std::string> text;
+    ParagraphRope text;
+    EditHistory history;
+    std::shared_ptr<const MappedFile> file;   // shared by copies whose paragraphs view it
     size_t position = 0;
     size_t linesPerScreen = 5;
 
+    void mapParagraphs(const std::string& filename);
+
 public:
-    Screen(const std::string& filename);
+    Screen(const std::string& filename, ScreenLoading loading = ScreenLoading::STREAM);
 
     Screen(const Screen& other);
 
     Screen(Screen&& other) noexcept;
 
-    const std::vector<std::string>& getText() const { return text; }
+    // Copies every paragraph out; prefer getParagraphs for large documents
+    std::vector<std::string> getText() const;
+    size_t getParagraphCount() const { return text.size(); }
+    Paragraph getParagraph(size_t index) const { return text.at(index); }
+    ParagraphCursor getParagraphs(size_t first = 0) const { return text.getCursor(first); }
 
     Screen& operator=(const Screen& other);
 
@@ -37,6 +56,15 @@ public:
     void deleteLine();
     void modifyLine(const std::string& newLine);
 
+    // Revert or reapply the last edit and move to the paragraph it touched; false if there is none
+    bool undo();
+    bool redo();
+    bool canUndo() const { return history.canUndo(); }
+    bool canRedo() const { return history.canRedo(); }
+    // Oldest edits are forgotten once the history holds more than this
+    void setHistoryLimit(size_t bytes) { history.setLimit(bytes); }
+    const EditHistory& getHistory() const { return history; }
+
     void display() const;
 };
 